@@ -1,10 +1,12 @@
-#define _POSIX_SOURCE
+#define _POSIX_C_SOURCE 200809L
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <errno.h>
+#include <time.h>
 
 #include <GraphBLAS.h>
 #if !defined(USE_SUITESPARSE)
@@ -19,11 +21,47 @@
 #include "prng.h" // for sample_roots
 #include "hooks.h"
 #include "io.h"
+#include "placement.h"
+#include "hugepage.h"
+#include "perfctr.h"
+#include "arena.h"
+#include "spgemm.h"
+#include "reorder.h"
+#include "khop.h"
+#if defined(HAVE_SEMIRING_KERNELS)
+#include "semiring-kernels.h"
+#endif
 
 int verbose = 0;
 
+// Drop self-loops from the n tuples and append (j, i, v) for each
+// (i, j, v) left; the arrays hold 2 * n.  Returns the new count.
+static GrB_Index
+symmetrize_tuples (GrB_Index *I, GrB_Index *J, uint64_t *V, GrB_Index n)
+{
+    GrB_Index m = 0;
+    for (GrB_Index k = 0; k < n; ++k)
+        if (I[k] != J[k]) {
+            I[m] = I[k];
+            J[m] = J[k];
+            V[m] = V[k];
+            ++m;
+        }
+    OMP(parallel for)
+    for (GrB_Index k = 0; k < m; ++k) {
+        I[m + k] = J[k];
+        J[m + k] = I[k];
+        V[m + k] = V[k];
+    }
+    return 2 * m;
+}
+
+// With symmetric, A is undirected and loop-free.  GrB_Matrix_build
+// drops the repeated tuples either way.  fp gets the generated edges,
+// as el-generator computes it.
 static GrB_Info
-make_A (GrB_Matrix *A, const GrB_Index NV, const GrB_Index NE, const GrB_Index NE_chunk_size)
+make_A (GrB_Matrix *A, const GrB_Index NV, const GrB_Index NE, const GrB_Index NE_chunk_size,
+        const bool symmetric, struct edge_fingerprint *fp)
 {
     GrB_Info info = GrB_SUCCESS;
 
@@ -39,9 +77,12 @@ make_A (GrB_Matrix *A, const GrB_Index NV, const GrB_Index NE, const GrB_Index N
     info = GrB_Matrix_new (A, GrB_UINT64, NV, NV);
     if (info != GrB_SUCCESS) goto done;
 
-    I = malloc (NE_chunk_size * sizeof (*I));
-    J = malloc (NE_chunk_size * sizeof (*J));
-    V = malloc (NE_chunk_size * sizeof (*V));
+    // Arena buffers outlive this call, so a second A (or a later run
+    // in the same process) does not go back to the allocator.
+    const GrB_Index ntuple = (symmetric ? 2 : 1) * NE_chunk_size;
+    I = arena_get (ARENA_EDGE_I, ntuple * sizeof (*I));
+    J = arena_get (ARENA_EDGE_J, ntuple * sizeof (*J));
+    V = arena_get (ARENA_EDGE_V, ntuple * sizeof (*V));
     if (!I || !J || !V) { info = GrB_OUT_OF_MEMORY; goto done; }
 
     if (nchunks > 1) {
@@ -55,7 +96,9 @@ make_A (GrB_Matrix *A, const GrB_Index NV, const GrB_Index NE, const GrB_Index N
         if (ck * NE_chunk_size + ngen > NE)
             ngen = NE - ck * NE_chunk_size;
         VERBOSELVL_PRINT(2, "  chunk %ld/%ld  %ld %ld\n", (long)ck+1, (long)nchunks, (long)NE, (long)ngen);
-        edge_list_64 ((int64_t*)I, (int64_t*)J, V, ck*NE_chunk_size, ngen);
+        edge_list_64 ((int64_t*)I, (int64_t*)J, V, ck*NE_chunk_size, ngen, fp);
+        if (symmetric)
+            ngen = symmetrize_tuples (I, J, V, ngen);
         if (nchunks > 1) {
             info = GrB_Matrix_build (tmpA, I, J, V, ngen, GrB_FIRST_UINT64);
             if (info != GrB_SUCCESS) goto done;
@@ -69,9 +112,6 @@ make_A (GrB_Matrix *A, const GrB_Index NV, const GrB_Index NE, const GrB_Index N
     }
 
  done:
-    if (V) free(V);
-    if (J) free(J);
-    if (I) free(I);
     if (used_tmpA) GrB_free (&tmpA);
     return info;
 }
@@ -85,8 +125,10 @@ make_B (GrB_Matrix *B, GrB_Index NV, GrB_Index B_ncols, GrB_Index B_used_ncols,
     GrB_Info info;
 
     const int64_t nroot = B_used_ncols * B_nents_per_col;
-    GrB_Index I[nroot], J[nroot];
-    uint64_t V[nroot];
+    GrB_Index *I = arena_get (ARENA_ROOT_I, nroot * sizeof (*I));
+    GrB_Index *J = arena_get (ARENA_ROOT_J, nroot * sizeof (*J));
+    uint64_t *V = arena_get (ARENA_ROOT_V, nroot * sizeof (*V));
+    if (!I || !J || !V) return GrB_OUT_OF_MEMORY;
 
     info = GrB_Matrix_new (B, GrB_UINT64, NV, B_ncols);
     if (info != GrB_SUCCESS) return info;
@@ -104,14 +146,116 @@ make_B (GrB_Matrix *B, GrB_Index NV, GrB_Index B_ncols, GrB_Index B_used_ncols,
     return info;
 }
 
+static double
+wall_ms (void)
+{
+    struct timespec t;
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return 1.0e3 * t.tv_sec + 1.0e-6 * t.tv_nsec;
+}
+
+// Storage requested for A and B.  Only SuiteSparse lets us choose.
+enum sparsity { SPARSITY_AUTO = 0, SPARSITY_HYPERSPARSE, SPARSITY_SPARSE, SPARSITY_BITMAP, SPARSITY_FULL };
+static const char *sparsity_names[] = { "auto", "hypersparse", "sparse", "bitmap", "full" };
+
+struct format_choice {
+    enum sparsity A_sparsity, B_sparsity;
+    bool A_by_col, B_by_col;
+};
+
+static enum sparsity
+parse_sparsity (const char *s)
+{
+    for (int k = 0; k <= SPARSITY_FULL; ++k)
+        if (!strcmp (s, sparsity_names[k])) return k;
+    DIE("Unknown sparsity \"%s\" (auto, hypersparse, sparse, bitmap, full)\n", s);
+}
+
+static bool
+parse_by_col (const char *s)
+{
+    if (!strcmp (s, "row")) return false;
+    if (!strcmp (s, "col")) return true;
+    DIE("Unknown orientation \"%s\" (row, col)\n", s);
+}
+
+static GrB_Info
+set_format (GrB_Matrix M, enum sparsity sparsity, bool by_col)
+{
+#if defined(USE_SUITESPARSE)
+    static const int control[] = { GxB_AUTO_SPARSITY, GxB_HYPERSPARSE, GxB_SPARSE, GxB_BITMAP, GxB_FULL };
+    GrB_Info info = GxB_Matrix_Option_set (M, GxB_FORMAT, by_col ? GxB_BY_COL : GxB_BY_ROW);
+    if (info != GrB_SUCCESS) return info;
+    return GxB_Matrix_Option_set (M, GxB_SPARSITY_CONTROL, control[sparsity]);
+#else
+    (void)M; (void)sparsity; (void)by_col;
+    return GrB_SUCCESS;
+#endif
+}
+
+// Reset B to B0 for the next hop value.  B is created on the first call
+// and then overwritten in place rather than freed and duplicated.  Its
+// requested storage is reapplied, which also undoes a switch to the
+// SpMM path.
+static GrB_Info
+reset_B (GrB_Matrix *B, GrB_Matrix B0, const struct format_choice *fc)
+{
+    GrB_Info info;
+#if defined(USE_SUITESPARSE)
+    if (*B) {
+        GrB_Index nr, nc;
+        GrB_Matrix_nrows (&nr, B0);
+        GrB_Matrix_ncols (&nc, B0);
+        info = GrB_Matrix_assign (*B, GrB_NULL, GrB_NULL, B0, GrB_ALL, nr, GrB_ALL, nc, GrB_DESC_R);
+        if (info != GrB_SUCCESS) return info;
+        return set_format (*B, fc->B_sparsity, fc->B_by_col);
+    }
+#else
+    if (*B) GrB_free (B);
+#endif
+    info = GrB_Matrix_dup (B, B0);
+    if (info != GrB_SUCCESS) return info;
+    return set_format (*B, fc->B_sparsity, fc->B_by_col);
+}
+
+// Per-hop wall times, and the hop from which B was treated as dense
+// (-1 if it never was).
+struct hop_times {
+    int spmm_hop;
+    double *ms;
+};
+
+// Past spmm_density (if positive), the remaining products are really
+// sparse times dense.  With SuiteSparse a bitmap B selects its SpMM
+// kernels; the switch is charged to the first SpMM hop.
 static GrB_Info
-timed_loop (GrB_Matrix B, GrB_Matrix A, const int nhop)
+timed_loop (GrB_Matrix B, GrB_Matrix A, const int nhop, const double spmm_density, struct hop_times *t)
 {
     GrB_Info info;
     extern long time_1, time_2, time_3;
+    t->spmm_hop = -1;
     for (int k = 0; k < nhop; ++k) {
+        const double begin = wall_ms ();
+#if defined(USE_SUITESPARSE)
+        if (k == t->spmm_hop) {
+            info = GxB_Matrix_Option_set (B, GxB_SPARSITY_CONTROL, GxB_BITMAP);
+            if (info != GrB_SUCCESS) return info;
+        }
+#endif
         info = GrB_mxm (B, GrB_NULL, GrB_NULL, GxB_MIN_FIRST_FP64, A, B, GrB_DESC_R);
         if (info != GrB_SUCCESS) return info;
+#if defined(USE_SUITESPARSE)
+        if (spmm_density > 0) {
+            GrB_wait(&B);
+            GrB_Index nvals, nr, nc;
+            GrB_Matrix_nvals (&nvals, B);
+            GrB_Matrix_nrows (&nr, B);
+            GrB_Matrix_ncols (&nc, B);
+            if (t->spmm_hop < 0 && k + 1 < nhop && nvals >= spmm_density * nr * nc)
+                t->spmm_hop = k + 1;
+        }
+#endif
+        t->ms[k] = wall_ms () - begin;
         VERBOSE_PRINT("times %ld %ld %ld\n", time_1, time_2, time_3);
     }
 #if !defined(USE_SUITESPARSE)
@@ -122,8 +266,337 @@ timed_loop (GrB_Matrix B, GrB_Matrix A, const int nhop)
     return info;
 }
 
+// Native backend operands.  C and E are scratch results, swapped with B
+// and D after each hop; D is B as a dense block on the SpMM path.  With
+// --tile the hops read A through its tiled copy T.
+struct native_operands {
+    struct spgemm_csr A, Bini, B, C;
+    struct spgemm_dense D, E;
+    struct spgemm_tiled T;
+    bool tiled;
+#if defined(HAVE_SEMIRING_KERNELS)
+    // --backend=template: A, B and C again with index_bits-wide column
+    // indices, multiplied by the kernel selected at startup.
+    struct kernel_csr KA, KB, KC;
+    kernel_mxm_fn mxm;
+#endif
+};
+
+// Reset the native B to B0 for the next hop value.
+static int
+reset_native (struct native_operands *n, const struct spgemm_csr *B0)
+{
+    if (spgemm_copy (&n->B, B0)) return -1;
+#if defined(HAVE_SEMIRING_KERNELS)
+    if (n->mxm)
+        return kernel_from_csr (&n->KB, n->KA.index_bits, B0->nrows, B0->ncols,
+                                B0->off, B0->colind, B0->val);
+#endif
+    return 0;
+}
+
+// The same iteration on plain CSR arrays.
+static int
+timed_loop_native (struct native_operands *n, const int nhop, enum spgemm_accum accum,
+                   const double spmm_density, struct hop_times *t)
+{
+    t->spmm_hop = -1;
+#if defined(HAVE_SEMIRING_KERNELS)
+    if (n->mxm) {
+        for (int k = 0; k < nhop; ++k) {
+            const double begin = wall_ms ();
+            if (n->mxm (&n->KC, &n->KA, &n->KB)) return -1;
+            struct kernel_csr tmp = n->KB;
+            n->KB = n->KC;
+            n->KC = tmp;
+            t->ms[k] = wall_ms () - begin;
+        }
+        return 0;
+    }
+#endif
+    for (int k = 0; k < nhop; ++k) {
+        const double begin = wall_ms ();
+        if (k == t->spmm_hop && spgemm_dense_from_csr (&n->D, &n->B)) return -1;
+        if (t->spmm_hop >= 0 && k >= t->spmm_hop) {
+            if (n->tiled ? spgemm_spmm_tiled (&n->E, &n->T, &n->D, SPGEMM_MIN_FIRST)
+                : spgemm_spmm (&n->E, &n->A, &n->D, SPGEMM_MIN_FIRST))
+                return -1;
+            struct spgemm_dense tmp = n->D;
+            n->D = n->E;
+            n->E = tmp;
+        } else {
+            if (n->tiled ? spgemm_mxm_tiled (&n->C, &n->T, &n->B, SPGEMM_MIN_FIRST)
+                : spgemm_mxm (&n->C, &n->A, &n->B, SPGEMM_MIN_FIRST, accum))
+                return -1;
+            struct spgemm_csr tmp = n->B;
+            n->B = n->C;
+            n->C = tmp;
+            if (spmm_density > 0 && k + 1 < nhop
+                && n->B.off[n->B.nrows] >= spmm_density * n->B.nrows * n->B.ncols)
+                t->spmm_hop = k + 1;
+        }
+        t->ms[k] = wall_ms () - begin;
+    }
+    return 0;
+}
+
+static GrB_Info
+run_loop (bool native, GrB_Matrix B, GrB_Matrix A, struct native_operands *n, const int nhop,
+          enum spgemm_accum accum, const double spmm_density, struct hop_times *t)
+{
+    if (native)
+        return timed_loop_native (n, nhop, accum, spmm_density, t) ? GrB_OUT_OF_MEMORY : GrB_SUCCESS;
+    return timed_loop (B, A, nhop, spmm_density, t);
+}
+
+static double
+sum_ms (const double *ms, int begin, int end)
+{
+    double out = 0.0;
+    for (int k = begin; k < end; ++k) out += ms[k];
+    return out;
+}
+
+// Entries in the result of the hop loop just run.
+static GrB_Index
+loop_nvals (bool native, GrB_Matrix B, const struct native_operands *n, const struct hop_times *t)
+{
+    GrB_Index nvals = 0;
+    if (!native)
+        GrB_Matrix_nvals (&nvals, B);
+#if defined(HAVE_SEMIRING_KERNELS)
+    else if (n->mxm)
+        nvals = kernel_nvals (&n->KB);
+#endif
+    else if (t->spmm_hop >= 0)
+        nvals = spgemm_dense_nvals (&n->D);
+    else
+        nvals = n->B.off[n->B.nrows];
+    return nvals;
+}
+
+// Copy M's tuples into a native CSR matrix.
+static GrB_Info
+native_from_mtx (struct spgemm_csr *out, GrB_Matrix M)
+{
+    GrB_Index nrows, ncols, *off, *colind;
+    uint64_t *val;
+    GrB_Info info = export_csr_copy (M, &nrows, &ncols, &off, &colind, &val);
+    if (info != GrB_SUCCESS) return info;
+    const struct spgemm_csr view = { nrows, ncols, off, colind, val, 0, 0 };
+    if (spgemm_copy (out, &view)) info = GrB_OUT_OF_MEMORY;
+    free_csr_copy (off, colind, val);
+    return info;
+}
+
+// The rows with an entry in column col of M, for --single-source.
+static uint64_t *
+column_rows (const struct spgemm_csr *M, uint64_t col, uint64_t *nrows_out)
+{
+    uint64_t *rows = malloc ((M->nrows ? M->nrows : 1) * sizeof (*rows));
+    if (!rows) return NULL;
+    uint64_t n = 0;
+    for (uint64_t i = 0; i < M->nrows; ++i)
+        for (uint64_t k = M->off[i]; k < M->off[i + 1]; ++k)
+            if (M->colind[k] == col) {
+                rows[n++] = i;
+                break;
+            }
+    *nrows_out = n;
+    return rows;
+}
+
+// Rebuild *M from its CSR arrays with the rows, and with cols the
+// columns, relabeled through perm[old] = new.
+static GrB_Info
+build_permuted (GrB_Matrix *M, GrB_Index nrows, GrB_Index ncols, const GrB_Index *off,
+                const GrB_Index *colind, const uint64_t *val, const uint64_t *perm, bool cols)
+{
+    GrB_Info info;
+    const GrB_Index nnz = off[nrows];
+    GrB_Index *I = malloc ((nnz ? nnz : 1) * sizeof (*I));
+    GrB_Index *J = malloc ((nnz ? nnz : 1) * sizeof (*J));
+    GrB_Matrix out = NULL;
+    if (!I || !J) {
+        info = GrB_OUT_OF_MEMORY;
+        goto done;
+    }
+    OMP(parallel for schedule(dynamic, 256))
+    for (int64_t i = 0; i < (int64_t)nrows; ++i)
+        for (GrB_Index k = off[i]; k < off[i + 1]; ++k) {
+            I[k] = perm[i];
+            J[k] = cols ? perm[colind[k]] : colind[k];
+        }
+    info = GrB_Matrix_new (&out, GrB_UINT64, nrows, ncols);
+    if (info != GrB_SUCCESS) goto done;
+    info = GrB_Matrix_build (out, I, J, val, nnz, GrB_FIRST_UINT64);
+    if (info != GrB_SUCCESS) {
+        GrB_free (&out);
+        goto done;
+    }
+    GrB_free (M);
+    *M = out;
+
+ done:
+    free (J);
+    free (I);
+    return info;
+}
+
+static GrB_Info
+permute_mtx (GrB_Matrix *M, const uint64_t *perm, bool cols)
+{
+    GrB_Index nrows, ncols, *off, *colind;
+    uint64_t *val;
+    GrB_Info info = export_csr_copy (*M, &nrows, &ncols, &off, &colind, &val);
+    if (info != GrB_SUCCESS) return info;
+    info = build_permuted (M, nrows, ncols, off, colind, val, perm, cols);
+    free_csr_copy (off, colind, val);
+    return info;
+}
+
+// Relabel A's vertices by mode, symmetrically.  *perm receives the
+// relabeling for B's rows; the gaps are reorder_mean_gap before and
+// after.
+static GrB_Info
+reorder_A (GrB_Matrix *A, enum reorder_mode mode, uint64_t **perm,
+           double *gap_before, double *gap_after)
+{
+    GrB_Index nrows, ncols, *off, *colind;
+    uint64_t *val;
+    GrB_Info info = export_csr_copy (*A, &nrows, &ncols, &off, &colind, &val);
+    if (info != GrB_SUCCESS) return info;
+    *perm = malloc ((nrows ? nrows : 1) * sizeof (**perm));
+    if (!*perm || reorder_perm (mode, nrows, off, colind, *perm))
+        info = GrB_OUT_OF_MEMORY;
+    else {
+        *gap_before = reorder_mean_gap (nrows, off, colind, NULL);
+        *gap_after = reorder_mean_gap (nrows, off, colind, *perm);
+        info = build_permuted (A, nrows, ncols, off, colind, val, *perm, true);
+    }
+    free_csr_copy (off, colind, val);
+    return info;
+}
+
 struct gengetopt_args_info args;
 
+static void
+set_nthreads (int nthreads)
+{
+    omp_set_num_threads (nthreads);
+#if defined(USE_SUITESPARSE)
+    GxB_set (GxB_NTHREADS, nthreads);
+#endif
+}
+
+// Re-place A's CSR arrays across NUMA nodes and record where its pages
+// live.  The SuiteSparse export / import pair hands over the arrays
+// without copying.
+static GrB_Info
+place_A (GrB_Matrix *A, enum placement_mode mode)
+{
+    GrB_Info info = GrB_SUCCESS;
+    const int nn = placement_nnodes ();
+    int64_t *pages = calloc (nn, sizeof (*pages));
+    if (!pages)
+        DIE_PERROR("Cannot malloc page counts");
+
+    hooks_set_attr_str ("numa_mode", placement_mode_name (mode));
+    hooks_set_attr_i64 ("numa_nodes", nn);
+    hooks_region_begin ("NUMA placement");
+
+#if defined(USE_SUITESPARSE)
+    GrB_Type type;
+    GrB_Index nrows, ncols;
+    GrB_Index *off = NULL, *colind = NULL;
+    uint64_t *val = NULL;
+    GrB_Index off_size, colind_size, val_size;
+    bool is_uniform, jumbled;
+
+    info = GxB_Matrix_export_CSR (A, &type, &nrows, &ncols, &off, &colind, (void**)&val, &off_size, &colind_size, &val_size, &is_uniform, &jumbled, GrB_NULL);
+    if (info != GrB_SUCCESS) goto done;
+
+    // An iso A has one value, not nnz; val_size is its size in bytes.
+    placement_csr (mode, off, nrows, colind, sizeof (*colind), is_uniform ? NULL : val, sizeof (*val));
+    placement_count_pages (off, (nrows+1) * sizeof (*off), pages);
+    placement_count_pages (colind, off[nrows] * sizeof (*colind), pages);
+    placement_count_pages (val, val_size, pages);
+
+    info = GxB_Matrix_import_CSR (A, type, nrows, ncols, &off, &colind, (void**)&val, off_size, colind_size, val_size, is_uniform, jumbled, GrB_NULL);
+
+ done:
+#else
+    (void)A;
+    VERBOSE_PRINT("NUMA placement of A needs the SuiteSparse export path; only pinning threads\n");
+#endif
+
+    for (int b = 0; b < nn; ++b) {
+        char key[32];
+        snprintf (key, sizeof (key), "node%d_MiB", b);
+        hooks_set_attr_f64 (key, (pages[b] * (double)sysconf (_SC_PAGESIZE)) / (1 << 20));
+    }
+    hooks_region_end ();
+    free (pages);
+    return info;
+}
+
+static GrB_Info
+run_ATA_native (GrB_Matrix A, enum spgemm_accum accum, int index_bits)
+{
+  struct spgemm_csr nA = { 0 }, nAT = { 0 }, nC = { 0 };
+  GrB_Info info = native_from_mtx (&nA, A);
+  if (info != GrB_SUCCESS) return info;
+
+#if defined(HAVE_SEMIRING_KERNELS)
+  if (index_bits) {
+    struct kernel_csr KA = { 0 }, KAT = { 0 }, KC = { 0 };
+    const kernel_mxm_fn mxm = kernel_select (index_bits, KERNEL_PLUS_TIMES);
+    if (kernel_from_csr (&KA, index_bits, nA.nrows, nA.ncols, nA.off, nA.colind, nA.val))
+      info = GrB_OUT_OF_MEMORY;
+
+    VERBOSE_PRINT("Running A^T * A with the %d-bit template kernel... ", index_bits);
+    hooks_set_attr_str ("backend", "template");
+    hooks_set_attr_i64 ("index_bits", index_bits);
+    hooks_region_begin ("ATA");
+    // The transpose stays in the C engine and 64-bit; it is converted
+    // as part of the product.
+    if (info == GrB_SUCCESS
+        && (spgemm_transpose (&nAT, &nA)
+            || kernel_from_csr (&KAT, index_bits, nAT.nrows, nAT.ncols, nAT.off, nAT.colind, nAT.val)
+            || mxm (&KC, &KAT, &KA)))
+      info = GrB_OUT_OF_MEMORY;
+    if (info == GrB_SUCCESS) hooks_set_attr_i64 ("nvals_C", kernel_nvals (&KC));
+    double iter_time = hooks_region_end ();
+    VERBOSE_PRINT("%g ms\n", iter_time);
+
+    kernel_free (&KC);
+    kernel_free (&KAT);
+    kernel_free (&KA);
+    spgemm_free (&nAT);
+    spgemm_free (&nA);
+    return info;
+  }
+#endif
+
+  VERBOSE_PRINT("Running A^T * A natively... ");
+  hooks_set_attr_str ("backend", "native");
+  hooks_set_attr_str ("accum", spgemm_accum_name (accum));
+  hooks_region_begin ("ATA");
+
+  // The transpose is part of the product, as it is for GrB_DESC_T0.
+  if (spgemm_transpose (&nAT, &nA) || spgemm_mxm (&nC, &nAT, &nA, SPGEMM_PLUS_TIMES, accum))
+    info = GrB_OUT_OF_MEMORY;
+
+  if (info == GrB_SUCCESS) hooks_set_attr_i64 ("nvals_C", nC.off[nC.nrows]);
+  double iter_time = hooks_region_end ();
+  VERBOSE_PRINT("%g ms\n", iter_time);
+
+  spgemm_free (&nC);
+  spgemm_free (&nAT);
+  spgemm_free (&nA);
+  return info;
+}
+
 static GrB_Info
 run_ATA (GrB_Matrix A)
 {
@@ -178,32 +651,116 @@ main (int argc, char **argv)
       khops = &one_hop;
       n_khops = 1;
     } else {
-      // Parse the khops arg
-      n_khops = 0;
-      khops = malloc (strlen (args.khops_arg) * sizeof (*khops));
-      if (!khops)
-        DIE_PERROR("Cannot malloc khops");
-      DEBUG_PRINT("parsing hops\n");
-      char *saveptr = NULL, *token = NULL;
-      char *inputptr = args.khops_arg;
-      for (;;) {
-        token = strtok_r (inputptr, " ,\n", &saveptr);
-        DEBUG_PRINT("hop %d  %p %p %p\n", n_khops, token, inputptr, saveptr);
-        inputptr = NULL;
-        if (token == NULL) break;
-        errno = 0;
-        long hop = strtol (token, NULL, 10);
-        if (hop <= 0)
-          DIE("Invalid hop value: %ld\n", hop);
-
-        if (errno)
-          DIE_PERROR("Error parsing hop %d", n_khops+1);
-
-        khops[n_khops++] = hop;
-      }
-      DEBUG_PRINT("done parsing hops\n");
+      khops = parse_long_list (args.khops_arg, "hop", &n_khops);
+    }
+
+    // A single pass at the current thread count unless sweeping.
+    int n_nthreads = 1;
+    long *nthreads = NULL;
+    long cur_nthreads = 0;
+    if (args.threads_sweep_given) {
+      if (args.ATA_flag)
+        DIE("--threads-sweep applies to the hop loop, not --ATA\n");
+      nthreads = parse_long_list (args.threads_sweep_arg, "thread count", &n_nthreads);
+    } else
+      nthreads = &cur_nthreads;
+
+    // The template backend is the native one with its products done by
+    // the C++ kernels.
+    bool native = false, templ = false;
+    if (!strcmp (args.backend_arg, "native"))
+        native = true;
+    else if (!strcmp (args.backend_arg, "template")) {
+#if !defined(HAVE_SEMIRING_KERNELS)
+        DIE("This build has no template kernels\n");
+#endif
+        native = templ = true;
+    } else if (strcmp (args.backend_arg, "graphblas"))
+        DIE("Unknown backend \"%s\" (graphblas, native, template)\n", args.backend_arg);
+    const enum spgemm_accum accum = spgemm_accum_parse (args.accum_arg);
+
+    double spmm_density = 0.0;
+    const bool spmm_compare = !strcmp (args.spmm_arg, "compare");
+    if (spmm_compare || !strcmp (args.spmm_arg, "auto"))
+        spmm_density = args.spmm_density_arg;
+    else if (strcmp (args.spmm_arg, "off"))
+        DIE("Unknown SpMM mode \"%s\" (off, auto, compare)\n", args.spmm_arg);
+    if (spmm_density > 1.0)
+        DIE("--spmm-density must be at most 1\n");
+    if (templ && spmm_density > 0)
+        DIE("--spmm needs --backend=graphblas or native\n");
+    if (args.kernel_compare_flag && (!templ || args.ATA_flag))
+        DIE("--kernel-compare applies to the --backend=template hop loop\n");
+    const bool single_source = args.single_source_flag;
+    if (single_source && (args.b_used_ncols_arg != 1 || args.run_powers_flag || args.ATA_flag))
+        DIE("--single-source applies to the hop loop with --b-used-ncols=1\n");
+    if (args.frontier_density_arg < 0)
+        DIE("--frontier-density must be nonnegative\n");
+#if !defined(USE_SUITESPARSE)
+    if (spmm_density > 0 && !native) {
+        VERBOSE_PRINT("LucataGraphBLAS has no sparsity control; --spmm needs --backend=native here\n");
+        spmm_density = 0.0;
+    }
+#endif
+
+    // Tile sizes for the native hop loop; zero is untiled.
+    uint64_t tile_rows = 0, tile_cols = 0;
+    if (!strcmp (args.tile_arg, "auto"))
+        spgemm_tile_auto (args.b_ncols_arg, &tile_rows, &tile_cols);
+    else if (strcmp (args.tile_arg, "off")
+             && (sscanf (args.tile_arg, "%" SCNu64 "x%" SCNu64, &tile_rows, &tile_cols) != 2
+                 || !tile_rows || !tile_cols))
+        DIE("Unknown tiling \"%s\" (off, auto, or ROWSxCOLS)\n", args.tile_arg);
+    if (tile_rows && (!native || templ || args.run_powers_flag || args.ATA_flag))
+        DIE("--tile applies to the native A * B hop loop\n");
+
+    // 0 is decided once NV is known.
+    int index_bits = 0;
+    if (!strcmp (args.index_bits_arg, "32"))
+        index_bits = 32;
+    else if (!strcmp (args.index_bits_arg, "64"))
+        index_bits = 64;
+    else if (strcmp (args.index_bits_arg, "auto"))
+        DIE("Unknown index width \"%s\" (auto, 32, 64)\n", args.index_bits_arg);
+
+    // One format unless sweeping.  The sweep leaves out bitmap and
+    // full A, which are NV^2 in size.
+    const bool format_sweep = args.format_sweep_flag;
+    struct format_choice *formats = NULL;
+    int n_formats = 0;
+    if (format_sweep) {
+#if !defined(USE_SUITESPARSE)
+        DIE("--format-sweep needs SuiteSparse\n");
+#endif
+        if (native || args.ATA_flag)
+            DIE("--format-sweep applies to the GraphBLAS hop loop\n");
+        formats = malloc (3 * 2 * 4 * 2 * sizeof (*formats));
+        if (!formats)
+            DIE_PERROR("Cannot malloc formats");
+        for (int as = SPARSITY_AUTO; as <= SPARSITY_SPARSE; ++as)
+            for (int ac = 0; ac < 2; ++ac)
+                for (int bs = SPARSITY_AUTO; bs <= SPARSITY_BITMAP; ++bs)
+                    for (int bc = 0; bc < 2; ++bc)
+                        formats[n_formats++] = (struct format_choice){ as, bs, ac, bc };
+    } else {
+        formats = malloc (sizeof (*formats));
+        if (!formats)
+            DIE_PERROR("Cannot malloc formats");
+        formats[0].A_sparsity = parse_sparsity (args.A_sparsity_arg);
+        formats[0].A_by_col = parse_by_col (args.A_format_arg);
+        formats[0].B_sparsity = parse_sparsity (args.B_sparsity_arg);
+        formats[0].B_by_col = parse_by_col (args.B_format_arg);
+        n_formats = 1;
+#if !defined(USE_SUITESPARSE)
+        if (args.A_sparsity_given || args.A_format_given || args.B_sparsity_given || args.B_format_given)
+            VERBOSE_PRINT("LucataGraphBLAS has no format control; ignoring the format options\n");
+#endif
     }
 
+    const enum reorder_mode reorder = reorder_mode_parse (args.reorder_arg);
+    const enum placement_mode numa_mode = placement_mode_parse (args.numa_arg);
+    hugepage_init (hugepage_mode_parse (args.hugepages_arg));
+
     int fd = -1;
     if (args.filename_arg)
         fd = open_filename (args.filename_arg);
@@ -217,14 +774,29 @@ main (int argc, char **argv)
                   );
 
     GrB_Info info;
-    GrB_Matrix A, Bini, B;
+    GrB_Matrix A, Bini, B = NULL;
     GrB_Index nvals_A = 0;
     GrB_Index nvals_B = 0;
 
+#if defined(USE_SUITESPARSE)
+    // Imported CSR arrays become the library's to free, so it must use
+    // the same allocator.  Older releases take an extra thread-safety
+    // flag.
+    if (hugepage_get_mode () != HUGEPAGE_OFF)
+#if GxB_IMPLEMENTATION_MAJOR >= 5
+        info = GxB_init (GrB_NONBLOCKING, hugepage_malloc, hugepage_calloc, hugepage_realloc, hugepage_free);
+#else
+        info = GxB_init (GrB_NONBLOCKING, hugepage_malloc, hugepage_calloc, hugepage_realloc, hugepage_free, true);
+#endif
+    else
+#endif
     info = GrB_init (GrB_NONBLOCKING);
     if (info != GrB_SUCCESS)
         DIE("Error initializing GraphBLAS: %ld\n", (long)info);
 
+    // Pin before anything is built so first touch is spread too.
+    placement_pin_threads (numa_mode);
+
     VERBOSE_PRINT("Creating A... ");
     if (!args.no_time_A_flag) {
         hooks_set_attr_i64 ("scale", SCALE);
@@ -232,11 +804,16 @@ main (int argc, char **argv)
         hooks_set_attr_f64 ("A", args.A_arg);
         hooks_set_attr_f64 ("B", args.B_arg);
         hooks_set_attr_f64 ("noisefact", NOISEFACT);
+        hooks_set_attr_i64 ("symmetrize", args.symmetrize_flag);
         hooks_region_begin ("Generating matrix A");
     }
 
+    struct edge_fingerprint A_fp = { 0, 0 };
+    char A_fp_str[EDGE_FINGERPRINT_LEN + 1] = "";
     if (fd < 0 || args.dump_flag) {
-        info = make_A (&A, NV, NE, args.NE_chunk_size_arg);
+        info = make_A (&A, NV, NE, args.NE_chunk_size_arg, args.symmetrize_flag, &A_fp);
+        snprintf (A_fp_str, sizeof (A_fp_str), EDGE_FINGERPRINT_FMT,
+                  A_fp.multiset, A_fp.ordered);
     } else {
         DEBUG_PRINT("Reading A ... ");
         if (args.binary_flag)
@@ -252,8 +829,11 @@ main (int argc, char **argv)
         DEBUG_PRINT("done\n");
     }
     if (fd >= 0 && args.dump_flag) {
+        // The binary dump's name is free text; carry the fingerprint.
+        char A_name[64];
+        snprintf (A_name, sizeof (A_name), "A --fingerprint %s", A_fp_str);
         if (args.binary_flag)
-            make_binfile_from_mtx (A, "A", fd);
+            make_binfile_from_mtx (A, A_name, fd);
         else
             make_file_from_mtx (A, "A", fd);
     }
@@ -263,6 +843,8 @@ main (int argc, char **argv)
         GrB_Index nvals;
         GrB_Matrix_nvals (&nvals, A);
         hooks_set_attr_i64 ("nvals", nvals);
+        if (A_fp_str[0])
+            hooks_set_attr_str ("fingerprint", A_fp_str);
         A_time = hooks_region_end ();
     }
     if (info != GrB_SUCCESS)
@@ -270,10 +852,44 @@ main (int argc, char **argv)
 
     GrB_Matrix_nvals (&nvals_A, A);
 
+    if (!templ)
+        index_bits = 0;
+    else if (!index_bits)
+        index_bits = NV <= (GrB_Index)UINT32_MAX + 1 ? 32 : 64;
+    else if (index_bits == 32 && NV > (GrB_Index)UINT32_MAX + 1)
+        DIE("A has too many vertices for 32-bit indices\n");
+
     VERBOSE_PRINT("%g ms\n", A_time);
 
+    // Relabel before A is placed or timed; B's rows follow.
+    uint64_t *perm = NULL;
+    if (reorder != REORDER_NONE) {
+        VERBOSE_PRINT("Reordering A by %s... ", reorder_mode_name (reorder));
+        double gap_before = 0.0, gap_after = 0.0;
+        hooks_set_attr_str ("reorder", reorder_mode_name (reorder));
+        hooks_region_begin ("Reordering");
+        info = reorder_A (&A, reorder, &perm, &gap_before, &gap_after);
+        hooks_set_attr_f64 ("mean_gap_before", gap_before);
+        hooks_set_attr_f64 ("mean_gap_after", gap_after);
+        double reorder_time = hooks_region_end ();
+        if (info != GrB_SUCCESS)
+            DIE("Error reordering A: %ld\n", (long)info);
+        VERBOSE_PRINT("%g ms, mean gap %g -> %g\n", reorder_time, gap_before, gap_after);
+    }
+
+    if (numa_mode != PLACEMENT_NONE) {
+        info = place_A (&A, numa_mode);
+        if (info != GrB_SUCCESS)
+            DIE("Error placing A: %ld\n", (long)info);
+    }
+
     if (args.ATA_flag) {
-      info = run_ATA (A);
+      if (!native) {
+        info = set_format (A, formats[0].A_sparsity, formats[0].A_by_col);
+        if (info != GrB_SUCCESS)
+          DIE("Error setting A's format: %ld\n", (long)info);
+      }
+      info = native ? run_ATA_native (A, accum, index_bits) : run_ATA (A);
       if (info != GrB_SUCCESS)
         DIE("Error running ATA: %ld\n", (long)info);
     } else {
@@ -311,39 +927,334 @@ main (int argc, char **argv)
           DIE("Error making Bini: %ld\n", (long)info);
 
         VERBOSE_PRINT("%g ms\n", Bini_time);
+        if (perm) {
+          info = permute_mtx (&Bini, perm, false);
+          if (info != GrB_SUCCESS)
+            DIE("Error reordering Bini: %ld\n", (long)info);
+        }
         GrB_Matrix_nvals (&nvals_B, Bini);
       }
 
       if (fd >= 0 || !args.dump_flag) {
-        for (int k = 0; k < n_khops; ++k) {
-          if (args.run_powers_flag || args.ATA_flag)
-            info = GrB_Matrix_dup (&B, A);
-          else
-            info = GrB_Matrix_dup (&B, Bini);
+        struct native_operands n = { 0 };
+        if (native) {
+          VERBOSE_PRINT("Copying to native CSR... ");
+          hooks_region_begin ("Native CSR export");
+          info = native_from_mtx (&n.A, A);
+          if (info == GrB_SUCCESS && !args.run_powers_flag)
+            info = native_from_mtx (&n.Bini, Bini);
+#if defined(HAVE_SEMIRING_KERNELS)
+          // Dispatched here, once; the hops call through n.mxm.
+          if (info == GrB_SUCCESS && templ) {
+            n.mxm = kernel_select (index_bits, KERNEL_MIN_FIRST);
+            if (kernel_from_csr (&n.KA, index_bits, n.A.nrows, n.A.ncols, n.A.off, n.A.colind, n.A.val))
+              info = GrB_OUT_OF_MEMORY;
+          }
+#endif
+          double export_time = hooks_region_end ();
+          if (info != GrB_SUCCESS)
+            DIE("Error copying to native CSR: %ld\n", (long)info);
+          VERBOSE_PRINT("%g ms\n", export_time);
+
+          if (tile_rows) {
+            VERBOSE_PRINT("Tiling A into %" PRIu64 "x%" PRIu64 " tiles... ", tile_rows, tile_cols);
+            hooks_set_attr_i64 ("tile_rows", tile_rows);
+            hooks_set_attr_i64 ("tile_cols", tile_cols);
+            hooks_region_begin ("Tiling A");
+            const int rc = spgemm_tile (&n.T, &n.A, tile_rows, tile_cols);
+            if (!rc) hooks_set_attr_i64 ("ntiles", n.T.ntiles);
+            double tile_time = hooks_region_end ();
+            if (rc)
+              DIE_PERROR("Cannot tile A");
+            n.tiled = true;
+            VERBOSE_PRINT("%g ms\n", tile_time);
+          }
+        }
+
+        // The bitmap engine walks the native A, and A^T for its push
+        // hops, from the rows of Bini's one used column.
+        struct khop K = { 0 };
+        struct spgemm_csr AT = { 0 };
+        uint64_t *roots = NULL, nroots = 0;
+        if (single_source) {
+          VERBOSE_PRINT("Setting up the single-source engine... ");
+          hooks_region_begin ("Single-source setup");
+          info = GrB_SUCCESS;
+          if (!native) {
+            info = native_from_mtx (&n.A, A);
+            if (info == GrB_SUCCESS)
+              info = native_from_mtx (&n.Bini, Bini);
+          }
+          if (info == GrB_SUCCESS
+              && (spgemm_transpose (&AT, &n.A) || khop_init (&K, n.A.nrows)
+                  || !(roots = column_rows (&n.Bini, 0, &nroots))))
+            info = GrB_OUT_OF_MEMORY;
+          hooks_set_attr_i64 ("nroots", nroots);
+          double setup_time = hooks_region_end ();
           if (info != GrB_SUCCESS)
-            DIE("Error copying B = Bini on hop value %d\n", k);
-
-          VERBOSE_PRINT("Running hop #%d for %ld steps... ", k, khops[k]);
-          if (!args.no_time_iter_flag) {
-            hooks_set_attr_i64 ("khop", khops[k]);
-            hooks_set_attr_i64 ("nvals_A", nvals_A);
-            hooks_set_attr_i64 ("nvals_B", nvals_B);
-            hooks_region_begin ("Iterating");
+            DIE("Error setting up the single-source engine: %ld\n", (long)info);
+          VERBOSE_PRINT("%g ms, %" PRIu64 " roots\n", setup_time, nroots);
+        }
+
+        // Wall times for the first thread count, the speedup baseline.
+        double *base_ms = calloc (n_formats * n_khops, sizeof (*base_ms));
+        // Per hop value: this format's time and the fastest so far.
+        double *fmt_ms = calloc (n_khops, sizeof (*fmt_ms));
+        double *best_ms = calloc (n_khops, sizeof (*best_ms));
+        int *best_f = malloc (n_khops * sizeof (*best_f));
+        if (!base_ms || !fmt_ms || !best_ms || !best_f)
+          DIE_PERROR("Cannot malloc sweep times");
+        for (int k = 0; k < n_khops; ++k) best_f[k] = -1;
+
+        long max_khop = 0;
+        for (int k = 0; k < n_khops; ++k)
+          if (khops[k] > max_khop) max_khop = khops[k];
+        struct hop_times times, cmp_times;
+        times.ms = calloc (max_khop, sizeof (*times.ms));
+        cmp_times.ms = calloc (max_khop, sizeof (*cmp_times.ms));
+        if (!times.ms || !cmp_times.ms)
+          DIE_PERROR("Cannot malloc hop times");
+
+        for (int t = 0; t < n_nthreads; ++t) {
+          if (nthreads[t] > 0) {
+            VERBOSE_PRINT("Using %ld threads\n", nthreads[t]);
+            set_nthreads (nthreads[t]);
           }
 
-          info = timed_loop (B, A, khops[k]);
+          for (int f = 0; f < n_formats; ++f) {
+            const struct format_choice *fc = &formats[f];
+            if (!native) {
+              info = set_format (A, fc->A_sparsity, fc->A_by_col);
+              if (info != GrB_SUCCESS)
+                DIE("Error setting A's format: %ld\n", (long)info);
+            }
+
+            for (int k = 0; k < n_khops; ++k) {
+              if (native)
+                info = reset_native (&n, args.run_powers_flag ? &n.A : &n.Bini) ? GrB_OUT_OF_MEMORY : GrB_SUCCESS;
+              else if (args.run_powers_flag || args.ATA_flag)
+                info = reset_B (&B, A, fc);
+              else
+                info = reset_B (&B, Bini, fc);
+              if (info != GrB_SUCCESS)
+                DIE("Error copying B = Bini on hop value %d\n", k);
 
-          double iter_time = 0.0;
-          if (!args.no_time_iter_flag) iter_time = hooks_region_end ();
-          VERBOSE_PRINT("%g ms\n", iter_time);
+              VERBOSE_PRINT("Running hop #%d for %ld steps... ", k, khops[k]);
+              if (!args.no_time_iter_flag) {
+                hooks_set_attr_i64 ("khop", khops[k]);
+                hooks_set_attr_i64 ("nvals_A", nvals_A);
+                hooks_set_attr_i64 ("nvals_B", nvals_B);
+                if (nthreads[t] > 0)
+                  hooks_set_attr_i64 ("nthreads", nthreads[t]);
+                hooks_set_attr_str ("hugepages", hugepage_mode_name (hugepage_get_mode ()));
+                hooks_set_attr_str ("backend", args.backend_arg);
+                hooks_set_attr_str ("reorder", reorder_mode_name (reorder));
+                if (native)
+                  hooks_set_attr_str ("accum", templ ? "dense" : n.tiled ? "tile" : spgemm_accum_name (accum));
+                if (templ) {
+                  // A's column indices at this width, the memory saving.
+                  hooks_set_attr_i64 ("index_bits", index_bits);
+                  hooks_set_attr_f64 ("colind_MiB", nvals_A * (index_bits / 8) / (double)(1 << 20));
+                }
+                if (n.tiled) {
+                  hooks_set_attr_i64 ("tile_rows", tile_rows);
+                  hooks_set_attr_i64 ("tile_cols", tile_cols);
+                }
+#if defined(USE_SUITESPARSE)
+                if (!native) {
+                  hooks_set_attr_str ("A_sparsity", sparsity_names[fc->A_sparsity]);
+                  hooks_set_attr_str ("A_format", fc->A_by_col ? "col" : "row");
+                  hooks_set_attr_str ("B_sparsity", sparsity_names[fc->B_sparsity]);
+                  hooks_set_attr_str ("B_format", fc->B_by_col ? "col" : "row");
+                }
+#endif
+                perfctr_begin ();
+                hooks_region_begin ("Iterating");
+              }
+
+              const double wall_begin = wall_ms ();
+              info = run_loop (native, B, A, &n, khops[k], accum, spmm_density, &times);
+              const double iter_wall = wall_ms () - wall_begin;
+              fmt_ms[k] = iter_wall;
+
+              if (!args.no_time_iter_flag) {
+                int64_t counts[PERFCTR_NEVENTS];
+                perfctr_end (counts);
+                for (int e = 0; e < PERFCTR_NEVENTS; ++e)
+                  if (counts[e] >= 0) hooks_set_attr_i64 (perfctr_name (e), counts[e]);
+                const double thp_mib = hugepage_anon_huge_mib ();
+                if (thp_mib >= 0) hooks_set_attr_f64 ("anon_huge_MiB", thp_mib);
+                hooks_set_attr_f64 ("arena_MiB", arena_bytes () / (double)(1 << 20));
+                if (spmm_density > 0) {
+                  const int sh = times.spmm_hop < 0 ? khops[k] : times.spmm_hop;
+                  hooks_set_attr_i64 ("spmm_hop", times.spmm_hop);
+                  hooks_set_attr_f64 ("spgemm_ms", sum_ms (times.ms, 0, sh));
+                  hooks_set_attr_f64 ("spmm_ms", sum_ms (times.ms, sh, khops[k]));
+                }
+              }
+
+              double iter_time = 0.0;
+              if (!args.no_time_iter_flag) iter_time = hooks_region_end ();
+              VERBOSE_PRINT("%g ms\n", iter_time);
+              if (info != GrB_SUCCESS)
+                DIE("Error iterating hop value %d: %ld\n", k, (long)info);
+              // Taken before the comparisons below rerun the loop.
+              const GrB_Index result_nvals = single_source ? loop_nvals (native, B, &n, &times) : 0;
+
+              if (spmm_compare && times.spmm_hop >= 0) {
+                // Rerun on the sparse path alone to time the same tail.
+                if (native)
+                  info = reset_native (&n, args.run_powers_flag ? &n.A : &n.Bini) ? GrB_OUT_OF_MEMORY : GrB_SUCCESS;
+                else
+                  info = reset_B (&B, args.run_powers_flag ? A : Bini, fc);
+                if (info != GrB_SUCCESS)
+                  DIE("Error copying B = Bini on hop value %d\n", k);
+                hooks_set_attr_i64 ("khop", khops[k]);
+                hooks_set_attr_i64 ("spmm_hop", times.spmm_hop);
+                hooks_set_attr_str ("backend", args.backend_arg);
+                hooks_region_begin ("SpMM comparison");
+                info = run_loop (native, B, A, &n, khops[k], accum, 0.0, &cmp_times);
+                const double spmm_ms = sum_ms (times.ms, times.spmm_hop, khops[k]);
+                const double spgemm_ms = sum_ms (cmp_times.ms, times.spmm_hop, khops[k]);
+                hooks_set_attr_f64 ("spmm_ms", spmm_ms);
+                hooks_set_attr_f64 ("spgemm_ms", spgemm_ms);
+                hooks_set_attr_f64 ("speedup", spgemm_ms / spmm_ms);
+                hooks_region_end ();
+                if (info != GrB_SUCCESS)
+                  DIE("Error iterating hop value %d: %ld\n", k, (long)info);
+                VERBOSE_PRINT("  hops %d-%ld: SpMM %g ms, SpGEMM %g ms\n",
+                              times.spmm_hop + 1, khops[k], spmm_ms, spgemm_ms);
+              }
+
+              if (args.kernel_compare_flag) {
+                // The same hops through GrB_mxm, as timed_loop runs them.
+                info = reset_B (&B, args.run_powers_flag ? A : Bini, fc);
+                if (info != GrB_SUCCESS)
+                  DIE("Error copying B = Bini on hop value %d\n", k);
+                hooks_set_attr_i64 ("khop", khops[k]);
+                hooks_set_attr_i64 ("index_bits", index_bits);
+                hooks_region_begin ("Kernel comparison");
+                info = timed_loop (B, A, khops[k], 0.0, &cmp_times);
+                const double grb_ms = sum_ms (cmp_times.ms, 0, khops[k]);
+                const double templ_ms = sum_ms (times.ms, 0, khops[k]);
+                hooks_set_attr_f64 ("template_ms", templ_ms);
+                hooks_set_attr_f64 ("graphblas_ms", grb_ms);
+                hooks_set_attr_f64 ("speedup", grb_ms / templ_ms);
+                hooks_region_end ();
+                if (info != GrB_SUCCESS)
+                  DIE("Error iterating hop value %d: %ld\n", k, (long)info);
+                VERBOSE_PRINT("  %ld hops: template %g ms, GrB_mxm %g ms\n",
+                              khops[k], templ_ms, grb_ms);
+              }
 
-          GrB_free (&B);
+              if (single_source) {
+                // The same hops on the bitmap frontier, beside the loop.
+                hooks_set_attr_i64 ("khop", khops[k]);
+                hooks_set_attr_str ("backend", args.backend_arg);
+                hooks_set_attr_f64 ("frontier_density", args.frontier_density_arg);
+                hooks_region_begin ("Single-source k-hop");
+                khop_reset (&K, roots, nroots);
+                const double begin = wall_ms ();
+                uint64_t frontier = K.count;
+                for (long h = 0; h < khops[k]; ++h)
+                  frontier = khop_step (&K, &n.A, &AT, args.frontier_density_arg);
+                const double bitmap_ms = wall_ms () - begin;
+                const double loop_ms = sum_ms (times.ms, 0, khops[k]);
+                hooks_set_attr_i64 ("frontier", frontier);
+                hooks_set_attr_i64 ("nvals_loop", result_nvals);
+                hooks_set_attr_i64 ("visited", khop_visited (&K));
+                hooks_set_attr_i64 ("pushes", K.pushes);
+                hooks_set_attr_i64 ("pulls", K.pulls);
+                hooks_set_attr_f64 ("bitmap_ms", bitmap_ms);
+                hooks_set_attr_f64 ("loop_ms", loop_ms);
+                hooks_set_attr_f64 ("speedup", loop_ms / bitmap_ms);
+                hooks_region_end ();
+                VERBOSE_PRINT("  %ld hops: bitmap %g ms (%d push, %d pull), %s loop %g ms\n",
+                              khops[k], bitmap_ms, K.pushes, K.pulls, args.backend_arg, loop_ms);
+                if (frontier != result_nvals)
+                  fprintf (stderr, "Single-source frontier has %" PRIu64 " vertices, the loop's B %" PRIu64 "\n",
+                           frontier, (uint64_t)result_nvals);
+              }
+
+              if (args.threads_sweep_given) {
+                // clock()-based region times sum over threads, so scaling
+                // uses wall time.
+                if (t == 0) base_ms[f * n_khops + k] = iter_wall;
+                const double speedup = base_ms[f * n_khops + k] / iter_wall;
+                const double efficiency = speedup * nthreads[0] / nthreads[t];
+                VERBOSE_PRINT("  %ld threads: %g ms wall, speedup %g, efficiency %g\n",
+                              nthreads[t], iter_wall, speedup, efficiency);
+                hooks_set_attr_i64 ("khop", khops[k]);
+                hooks_set_attr_i64 ("nthreads", nthreads[t]);
+                hooks_set_attr_i64 ("base_nthreads", nthreads[0]);
+                hooks_set_attr_f64 ("iter_wall_ms", iter_wall);
+                hooks_set_attr_f64 ("speedup", speedup);
+                hooks_set_attr_f64 ("efficiency", efficiency);
+                hooks_region_begin ("Thread scaling");
+                hooks_region_end ();
+              }
+            }
+
+            if (format_sweep) {
+              for (int k = 0; k < n_khops; ++k) {
+                if (best_f[k] >= 0 && best_ms[k] <= fmt_ms[k]) continue;
+                best_f[k] = f;
+                best_ms[k] = fmt_ms[k];
+              }
+            }
+          }
+
+          if (format_sweep) {
+            for (int k = 0; k < n_khops; ++k) {
+              const struct format_choice *fc = &formats[best_f[k]];
+              VERBOSE_PRINT("  %ld hops: fastest A %s by %s, B %s by %s, %g ms\n", khops[k],
+                            sparsity_names[fc->A_sparsity], fc->A_by_col ? "col" : "row",
+                            sparsity_names[fc->B_sparsity], fc->B_by_col ? "col" : "row", best_ms[k]);
+              hooks_set_attr_i64 ("scale", SCALE);
+              hooks_set_attr_i64 ("khop", khops[k]);
+              if (nthreads[t] > 0)
+                hooks_set_attr_i64 ("nthreads", nthreads[t]);
+              hooks_set_attr_str ("A_sparsity", sparsity_names[fc->A_sparsity]);
+              hooks_set_attr_str ("A_format", fc->A_by_col ? "col" : "row");
+              hooks_set_attr_str ("B_sparsity", sparsity_names[fc->B_sparsity]);
+              hooks_set_attr_str ("B_format", fc->B_by_col ? "col" : "row");
+              hooks_set_attr_f64 ("iter_wall_ms", best_ms[k]);
+              hooks_region_begin ("Format sweep best");
+              hooks_region_end ();
+              best_f[k] = -1;
+            }
+          }
         }
+        free (roots);
+        khop_free (&K);
+        spgemm_free (&AT);
+        free (cmp_times.ms);
+        free (times.ms);
+        free (best_f);
+        free (best_ms);
+        free (fmt_ms);
+        free (base_ms);
+        if (B) GrB_free (&B);
+#if defined(HAVE_SEMIRING_KERNELS)
+        kernel_free (&n.KC);
+        kernel_free (&n.KB);
+        kernel_free (&n.KA);
+#endif
+        spgemm_tiled_free (&n.T);
+        spgemm_dense_free (&n.E);
+        spgemm_dense_free (&n.D);
+        spgemm_free (&n.C);
+        spgemm_free (&n.B);
+        spgemm_free (&n.Bini);
+        spgemm_free (&n.A);
       }
     }
 
     if (fd >= 0) close (fd);
+    free (formats);
+    free (perm);
 
     VERBOSE_PRINT("DONE\n");
     GrB_finalize ();
+    arena_release_all ();
 }
@@ -0,0 +1,30 @@
+#include "arena.h"
+
+#include "hugepage.h"
+
+static struct {
+  void *p;
+  size_t cap;
+} slots[ARENA_NSLOTS];
+
+void *arena_get(enum arena_slot s, size_t bytes) {
+  if (bytes <= slots[s].cap) return slots[s].p;
+  hugepage_free(slots[s].p);
+  slots[s].p = hugepage_malloc(bytes);
+  slots[s].cap = slots[s].p ? bytes : 0;
+  return slots[s].p;
+}
+
+size_t arena_bytes(void) {
+  size_t out = 0;
+  for (int s = 0; s < ARENA_NSLOTS; ++s) out += slots[s].cap;
+  return out;
+}
+
+void arena_release_all(void) {
+  for (int s = 0; s < ARENA_NSLOTS; ++s) {
+    hugepage_free(slots[s].p);
+    slots[s].p = NULL;
+    slots[s].cap = 0;
+  }
+}
@@ -0,0 +1,27 @@
+#if !defined(ARENA_HEADER_)
+#define ARENA_HEADER_
+#include <stddef.h>
+
+/* Long-lived scratch buffers, one per slot.  arena_get returns the
+   slot's buffer, growing it (without preserving contents) only when a
+   larger size is requested, so repeated chunks, hop values and runs
+   reuse the same memory.  Buffers come from hugepage_malloc. */
+
+enum arena_slot {
+  ARENA_EDGE_I = 0,
+  ARENA_EDGE_J,
+  ARENA_EDGE_V,
+  ARENA_ROOT_I,
+  ARENA_ROOT_J,
+  ARENA_ROOT_V,
+  ARENA_CSR_OFF,
+  ARENA_CSR_COLIND,
+  ARENA_CSR_VAL,
+  ARENA_NSLOTS
+};
+
+void *arena_get (enum arena_slot, size_t);
+size_t arena_bytes (void);
+void arena_release_all (void);
+
+#endif /* ARENA_HEADER_ */
@@ -34,31 +34,50 @@ const char *gengetopt_args_info_versiontext = "Copyright 2021-2022, Lucata Corpo
 const char *gengetopt_args_info_description = "Times the iteration of B = A*B";
 
 const char *gengetopt_args_info_help[] = {
-  "  -h, --help                Print help and exit",
-  "  -V, --version             Print version and exit",
-  "  -s, --scale=INT           Scale (log2 # vertices in A)  (default=`16')",
-  "  -e, --edgefactor=INT      Edge factor, so # edges = ef * 2^scale\n                              (default=`8')",
-  "  -A, --A=FLOAT             R-MAT upper left quadrant probability\n                              (default=`0.55')",
-  "  -B, --B=FLOAT             R-MAT upper right & lower left quadrant probability\n                              (default=`0.1')",
-  "  -N, --noisefact=FLOAT     Noise factor on each recursion  (default=`0.1')",
-  "      --run-powers          Run powers of the generated A matrix rather than\n                              applying A to B  (default=off)",
-  "      --ATA                 Multiply A^T * A once.  (default=off)",
+  "  -h, --help                    Print help and exit",
+  "  -V, --version                 Print version and exit",
+  "  -s, --scale=INT               Scale (log2 # vertices in A)  (default=`16')",
+  "  -e, --edgefactor=INT          Edge factor, so # edges = ef * 2^scale\n                                  (default=`8')",
+  "  -A, --A=FLOAT                 R-MAT upper left quadrant probability\n                                  (default=`0.55')",
+  "  -B, --B=FLOAT                 R-MAT upper right & lower left quadrant\n                                  probability  (default=`0.1')",
+  "  -N, --noisefact=FLOAT         Noise factor on each recursion  (default=`0.1')",
+  "      --symmetrize              Generate A undirected and without self-loops\n                                  (default=off)",
+  "      --run-powers              Run powers of the generated A matrix rather\n                                  than applying A to B  (default=off)",
+  "      --ATA                     Multiply A^T * A once.  (default=off)",
+  "      --backend=STRING          Multiply with graphblas, the in-tree native CSR\n                                  engine, or its C++ template kernels\n                                  (default=`graphblas')",
+  "      --accum=STRING            Native engine accumulator: auto, dense, hash,\n                                  heap, or bitmap  (default=`auto')",
+  "      --index-bits=STRING       Column index width for the template kernels and\n                                  binary dumps: auto, 32, or 64 (dumps: auto is\n                                  64)  (default=`auto')",
+  "      --kernel-compare          Also time each template hop loop through\n                                  GrB_mxm  (default=off)",
+  "      --single-source           With b-used-ncols=1, also time each hop value\n                                  on the bitmap frontier engine  (default=off)",
+  "      --frontier-density=FLOAT  Fraction of vertices in the frontier above\n                                  which the single-source engine pulls\n                                  (default=`0.05')",
+  "      --spmm=STRING             Switch to sparse-times-dense once B fills in:\n                                  off, auto, or compare (also time the sparse\n                                  path)  (default=`off')",
+  "      --spmm-density=FLOAT      Fraction of B's entries present that triggers\n                                  the switch  (default=`0.5')",
+  "      --tile=STRING             Native hop loop on A cut into L2-sized tiles:\n                                  off, auto, or ROWSxCOLS  (default=`off')",
+  "      --reorder=STRING          Relabel vertices before the hop loop: none,\n                                  degree, rcm, or community  (default=`none')",
+  "      --A-sparsity=STRING       Storage for A (SuiteSparse): auto, hypersparse,\n                                  sparse, bitmap, or full  (default=`auto')",
+  "      --A-format=STRING         Orientation of A (SuiteSparse): row or col\n                                  (default=`row')",
+  "      --B-sparsity=STRING       Storage for B (SuiteSparse): auto, hypersparse,\n                                  sparse, bitmap, or full  (default=`auto')",
+  "      --B-format=STRING         Orientation of B (SuiteSparse): row or col\n                                  (default=`row')",
+  "      --format-sweep            Time the hop loop over A and B storage\n                                  combinations and report the fastest\n                                  (default=off)",
   "",
-  "  -f, --filename=STRING     Filename to read/write for a CSR format",
-  "      --dump                Write a file to read  (default=off)",
-  "      --binary              File is in binary format  (default=off)",
+  "  -f, --filename=STRING         Filename to read/write for a CSR format",
+  "      --dump                    Write a file to read  (default=off)",
+  "      --binary                  File is in binary format  (default=off)",
+  "      --numa=STRING             NUMA placement of A: none, interleave, or\n                                  partition (pins threads)  (default=`none')",
+  "      --hugepages=STRING        Back A's edge and CSR arrays with 2 MiB pages:\n                                  off, thp, or explicit  (default=`off')",
   "",
-  "  -c, --b-ncols=INT         Number of columns in B  (default=`16')",
-  "  -C, --b-used-ncols=INT    Number of columns actually used in the initial B\n                              (default=`1')",
-  "  -E, --b-nents-col=INT     Number of entries per column in the initial B\n                              (default=`1')",
+  "  -c, --b-ncols=INT             Number of columns in B  (default=`16')",
+  "  -C, --b-used-ncols=INT        Number of columns actually used in the initial\n                                  B  (default=`1')",
+  "  -E, --b-nents-col=INT         Number of entries per column in the initial B\n                                  (default=`1')",
   "",
-  "  -k, --khops=STRING        Number of iterations / hops (can be a space-delim\n                              list)  (default=`2 4 8')",
+  "  -k, --khops=STRING            Number of iterations / hops (can be a\n                                  space-delim list)  (default=`2 4 8')",
+  "      --threads-sweep=STRING    Rerun the hop loop at each thread count\n                                  (space-delim list)",
   "",
-  "      --NE-chunk-size=LONG  Number of edges to generate in a chunk.\n                              (default=`1048576')",
-  "      --verbose[=INT]       Provide status updates via stdout.  (default=`1')",
-  "      --no-time-A           Do not time A  (default=off)",
-  "      --no-time-B           Do not time B  (default=off)",
-  "      --no-time-iter        Do not time iteration  (default=off)",
+  "      --NE-chunk-size=LONG      Number of edges to generate in a chunk.\n                                  (default=`1048576')",
+  "      --verbose[=INT]           Provide status updates via stdout.\n                                  (default=`1')",
+  "      --no-time-A               Do not time A  (default=off)",
+  "      --no-time-B               Do not time B  (default=off)",
+  "      --no-time-iter            Do not time iteration  (default=off)",
     0
 };
 
@@ -93,15 +112,34 @@ void clear_given (struct gengetopt_args_info *args_info)
   args_info->A_given = 0 ;
   args_info->B_given = 0 ;
   args_info->noisefact_given = 0 ;
+  args_info->symmetrize_given = 0 ;
   args_info->run_powers_given = 0 ;
   args_info->ATA_given = 0 ;
+  args_info->backend_given = 0 ;
+  args_info->accum_given = 0 ;
+  args_info->index_bits_given = 0 ;
+  args_info->kernel_compare_given = 0 ;
+  args_info->single_source_given = 0 ;
+  args_info->frontier_density_given = 0 ;
+  args_info->spmm_given = 0 ;
+  args_info->spmm_density_given = 0 ;
+  args_info->tile_given = 0 ;
+  args_info->reorder_given = 0 ;
+  args_info->A_sparsity_given = 0 ;
+  args_info->A_format_given = 0 ;
+  args_info->B_sparsity_given = 0 ;
+  args_info->B_format_given = 0 ;
+  args_info->format_sweep_given = 0 ;
   args_info->filename_given = 0 ;
   args_info->dump_given = 0 ;
   args_info->binary_given = 0 ;
+  args_info->numa_given = 0 ;
+  args_info->hugepages_given = 0 ;
   args_info->b_ncols_given = 0 ;
   args_info->b_used_ncols_given = 0 ;
   args_info->b_nents_col_given = 0 ;
   args_info->khops_given = 0 ;
+  args_info->threads_sweep_given = 0 ;
   args_info->NE_chunk_size_given = 0 ;
   args_info->verbose_given = 0 ;
   args_info->no_time_A_given = 0 ;
@@ -123,12 +161,44 @@ void clear_args (struct gengetopt_args_info *args_info)
   args_info->B_orig = NULL;
   args_info->noisefact_arg = 0.1;
   args_info->noisefact_orig = NULL;
+  args_info->symmetrize_flag = 0;
   args_info->run_powers_flag = 0;
   args_info->ATA_flag = 0;
+  args_info->backend_arg = gengetopt_strdup ("graphblas");
+  args_info->backend_orig = NULL;
+  args_info->accum_arg = gengetopt_strdup ("auto");
+  args_info->accum_orig = NULL;
+  args_info->index_bits_arg = gengetopt_strdup ("auto");
+  args_info->index_bits_orig = NULL;
+  args_info->kernel_compare_flag = 0;
+  args_info->single_source_flag = 0;
+  args_info->frontier_density_arg = 0.05;
+  args_info->frontier_density_orig = NULL;
+  args_info->spmm_arg = gengetopt_strdup ("off");
+  args_info->spmm_orig = NULL;
+  args_info->spmm_density_arg = 0.5;
+  args_info->spmm_density_orig = NULL;
+  args_info->tile_arg = gengetopt_strdup ("off");
+  args_info->tile_orig = NULL;
+  args_info->reorder_arg = gengetopt_strdup ("none");
+  args_info->reorder_orig = NULL;
+  args_info->A_sparsity_arg = gengetopt_strdup ("auto");
+  args_info->A_sparsity_orig = NULL;
+  args_info->A_format_arg = gengetopt_strdup ("row");
+  args_info->A_format_orig = NULL;
+  args_info->B_sparsity_arg = gengetopt_strdup ("auto");
+  args_info->B_sparsity_orig = NULL;
+  args_info->B_format_arg = gengetopt_strdup ("row");
+  args_info->B_format_orig = NULL;
+  args_info->format_sweep_flag = 0;
   args_info->filename_arg = NULL;
   args_info->filename_orig = NULL;
   args_info->dump_flag = 0;
   args_info->binary_flag = 0;
+  args_info->numa_arg = gengetopt_strdup ("none");
+  args_info->numa_orig = NULL;
+  args_info->hugepages_arg = gengetopt_strdup ("off");
+  args_info->hugepages_orig = NULL;
   args_info->b_ncols_arg = 16;
   args_info->b_ncols_orig = NULL;
   args_info->b_used_ncols_arg = 1;
@@ -137,6 +207,8 @@ void clear_args (struct gengetopt_args_info *args_info)
   args_info->b_nents_col_orig = NULL;
   args_info->khops_arg = gengetopt_strdup ("2 4 8");
   args_info->khops_orig = NULL;
+  args_info->threads_sweep_arg = NULL;
+  args_info->threads_sweep_orig = NULL;
   args_info->NE_chunk_size_arg = 1048576;
   args_info->NE_chunk_size_orig = NULL;
   args_info->verbose_arg = 1;
@@ -159,20 +231,39 @@ void init_args_info(struct gengetopt_args_info *args_info)
   args_info->A_help = gengetopt_args_info_help[4] ;
   args_info->B_help = gengetopt_args_info_help[5] ;
   args_info->noisefact_help = gengetopt_args_info_help[6] ;
-  args_info->run_powers_help = gengetopt_args_info_help[7] ;
-  args_info->ATA_help = gengetopt_args_info_help[8] ;
-  args_info->filename_help = gengetopt_args_info_help[10] ;
-  args_info->dump_help = gengetopt_args_info_help[11] ;
-  args_info->binary_help = gengetopt_args_info_help[12] ;
-  args_info->b_ncols_help = gengetopt_args_info_help[14] ;
-  args_info->b_used_ncols_help = gengetopt_args_info_help[15] ;
-  args_info->b_nents_col_help = gengetopt_args_info_help[16] ;
-  args_info->khops_help = gengetopt_args_info_help[18] ;
-  args_info->NE_chunk_size_help = gengetopt_args_info_help[20] ;
-  args_info->verbose_help = gengetopt_args_info_help[21] ;
-  args_info->no_time_A_help = gengetopt_args_info_help[22] ;
-  args_info->no_time_B_help = gengetopt_args_info_help[23] ;
-  args_info->no_time_iter_help = gengetopt_args_info_help[24] ;
+  args_info->symmetrize_help = gengetopt_args_info_help[7] ;
+  args_info->run_powers_help = gengetopt_args_info_help[8] ;
+  args_info->ATA_help = gengetopt_args_info_help[9] ;
+  args_info->backend_help = gengetopt_args_info_help[10] ;
+  args_info->accum_help = gengetopt_args_info_help[11] ;
+  args_info->index_bits_help = gengetopt_args_info_help[12] ;
+  args_info->kernel_compare_help = gengetopt_args_info_help[13] ;
+  args_info->single_source_help = gengetopt_args_info_help[14] ;
+  args_info->frontier_density_help = gengetopt_args_info_help[15] ;
+  args_info->spmm_help = gengetopt_args_info_help[16] ;
+  args_info->spmm_density_help = gengetopt_args_info_help[17] ;
+  args_info->tile_help = gengetopt_args_info_help[18] ;
+  args_info->reorder_help = gengetopt_args_info_help[19] ;
+  args_info->A_sparsity_help = gengetopt_args_info_help[20] ;
+  args_info->A_format_help = gengetopt_args_info_help[21] ;
+  args_info->B_sparsity_help = gengetopt_args_info_help[22] ;
+  args_info->B_format_help = gengetopt_args_info_help[23] ;
+  args_info->format_sweep_help = gengetopt_args_info_help[24] ;
+  args_info->filename_help = gengetopt_args_info_help[26] ;
+  args_info->dump_help = gengetopt_args_info_help[27] ;
+  args_info->binary_help = gengetopt_args_info_help[28] ;
+  args_info->numa_help = gengetopt_args_info_help[29] ;
+  args_info->hugepages_help = gengetopt_args_info_help[30] ;
+  args_info->b_ncols_help = gengetopt_args_info_help[32] ;
+  args_info->b_used_ncols_help = gengetopt_args_info_help[33] ;
+  args_info->b_nents_col_help = gengetopt_args_info_help[34] ;
+  args_info->khops_help = gengetopt_args_info_help[36] ;
+  args_info->threads_sweep_help = gengetopt_args_info_help[37] ;
+  args_info->NE_chunk_size_help = gengetopt_args_info_help[39] ;
+  args_info->verbose_help = gengetopt_args_info_help[40] ;
+  args_info->no_time_A_help = gengetopt_args_info_help[41] ;
+  args_info->no_time_B_help = gengetopt_args_info_help[42] ;
+  args_info->no_time_iter_help = gengetopt_args_info_help[43] ;
   
 }
 
@@ -267,13 +358,41 @@ cmdline_parser_release (struct gengetopt_args_info *args_info)
   free_string_field (&(args_info->A_orig));
   free_string_field (&(args_info->B_orig));
   free_string_field (&(args_info->noisefact_orig));
+  free_string_field (&(args_info->backend_arg));
+  free_string_field (&(args_info->backend_orig));
+  free_string_field (&(args_info->accum_arg));
+  free_string_field (&(args_info->accum_orig));
+  free_string_field (&(args_info->index_bits_arg));
+  free_string_field (&(args_info->index_bits_orig));
+  free_string_field (&(args_info->frontier_density_orig));
+  free_string_field (&(args_info->spmm_arg));
+  free_string_field (&(args_info->spmm_orig));
+  free_string_field (&(args_info->spmm_density_orig));
+  free_string_field (&(args_info->tile_arg));
+  free_string_field (&(args_info->tile_orig));
+  free_string_field (&(args_info->reorder_arg));
+  free_string_field (&(args_info->reorder_orig));
+  free_string_field (&(args_info->A_sparsity_arg));
+  free_string_field (&(args_info->A_sparsity_orig));
+  free_string_field (&(args_info->A_format_arg));
+  free_string_field (&(args_info->A_format_orig));
+  free_string_field (&(args_info->B_sparsity_arg));
+  free_string_field (&(args_info->B_sparsity_orig));
+  free_string_field (&(args_info->B_format_arg));
+  free_string_field (&(args_info->B_format_orig));
   free_string_field (&(args_info->filename_arg));
   free_string_field (&(args_info->filename_orig));
+  free_string_field (&(args_info->numa_arg));
+  free_string_field (&(args_info->numa_orig));
+  free_string_field (&(args_info->hugepages_arg));
+  free_string_field (&(args_info->hugepages_orig));
   free_string_field (&(args_info->b_ncols_orig));
   free_string_field (&(args_info->b_used_ncols_orig));
   free_string_field (&(args_info->b_nents_col_orig));
   free_string_field (&(args_info->khops_arg));
   free_string_field (&(args_info->khops_orig));
+  free_string_field (&(args_info->threads_sweep_arg));
+  free_string_field (&(args_info->threads_sweep_orig));
   free_string_field (&(args_info->NE_chunk_size_orig));
   free_string_field (&(args_info->verbose_orig));
   
@@ -320,16 +439,52 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
     write_into_file(outfile, "B", args_info->B_orig, 0);
   if (args_info->noisefact_given)
     write_into_file(outfile, "noisefact", args_info->noisefact_orig, 0);
+  if (args_info->symmetrize_given)
+    write_into_file(outfile, "symmetrize", 0, 0 );
   if (args_info->run_powers_given)
     write_into_file(outfile, "run-powers", 0, 0 );
   if (args_info->ATA_given)
     write_into_file(outfile, "ATA", 0, 0 );
+  if (args_info->backend_given)
+    write_into_file(outfile, "backend", args_info->backend_orig, 0);
+  if (args_info->accum_given)
+    write_into_file(outfile, "accum", args_info->accum_orig, 0);
+  if (args_info->index_bits_given)
+    write_into_file(outfile, "index-bits", args_info->index_bits_orig, 0);
+  if (args_info->kernel_compare_given)
+    write_into_file(outfile, "kernel-compare", 0, 0 );
+  if (args_info->single_source_given)
+    write_into_file(outfile, "single-source", 0, 0 );
+  if (args_info->frontier_density_given)
+    write_into_file(outfile, "frontier-density", args_info->frontier_density_orig, 0);
+  if (args_info->spmm_given)
+    write_into_file(outfile, "spmm", args_info->spmm_orig, 0);
+  if (args_info->spmm_density_given)
+    write_into_file(outfile, "spmm-density", args_info->spmm_density_orig, 0);
+  if (args_info->tile_given)
+    write_into_file(outfile, "tile", args_info->tile_orig, 0);
+  if (args_info->reorder_given)
+    write_into_file(outfile, "reorder", args_info->reorder_orig, 0);
+  if (args_info->A_sparsity_given)
+    write_into_file(outfile, "A-sparsity", args_info->A_sparsity_orig, 0);
+  if (args_info->A_format_given)
+    write_into_file(outfile, "A-format", args_info->A_format_orig, 0);
+  if (args_info->B_sparsity_given)
+    write_into_file(outfile, "B-sparsity", args_info->B_sparsity_orig, 0);
+  if (args_info->B_format_given)
+    write_into_file(outfile, "B-format", args_info->B_format_orig, 0);
+  if (args_info->format_sweep_given)
+    write_into_file(outfile, "format-sweep", 0, 0 );
   if (args_info->filename_given)
     write_into_file(outfile, "filename", args_info->filename_orig, 0);
   if (args_info->dump_given)
     write_into_file(outfile, "dump", 0, 0 );
   if (args_info->binary_given)
     write_into_file(outfile, "binary", 0, 0 );
+  if (args_info->numa_given)
+    write_into_file(outfile, "numa", args_info->numa_orig, 0);
+  if (args_info->hugepages_given)
+    write_into_file(outfile, "hugepages", args_info->hugepages_orig, 0);
   if (args_info->b_ncols_given)
     write_into_file(outfile, "b-ncols", args_info->b_ncols_orig, 0);
   if (args_info->b_used_ncols_given)
@@ -338,6 +493,8 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
     write_into_file(outfile, "b-nents-col", args_info->b_nents_col_orig, 0);
   if (args_info->khops_given)
     write_into_file(outfile, "khops", args_info->khops_orig, 0);
+  if (args_info->threads_sweep_given)
+    write_into_file(outfile, "threads-sweep", args_info->threads_sweep_orig, 0);
   if (args_info->NE_chunk_size_given)
     write_into_file(outfile, "NE-chunk-size", args_info->NE_chunk_size_orig, 0);
   if (args_info->verbose_given)
@@ -623,15 +780,34 @@ cmdline_parser_internal (
         { "A",	1, NULL, 'A' },
         { "B",	1, NULL, 'B' },
         { "noisefact",	1, NULL, 'N' },
+        { "symmetrize",	0, NULL, 0 },
         { "run-powers",	0, NULL, 0 },
         { "ATA",	0, NULL, 0 },
+        { "backend",	1, NULL, 0 },
+        { "accum",	1, NULL, 0 },
+        { "index-bits",	1, NULL, 0 },
+        { "kernel-compare",	0, NULL, 0 },
+        { "single-source",	0, NULL, 0 },
+        { "frontier-density",	1, NULL, 0 },
+        { "spmm",	1, NULL, 0 },
+        { "spmm-density",	1, NULL, 0 },
+        { "tile",	1, NULL, 0 },
+        { "reorder",	1, NULL, 0 },
+        { "A-sparsity",	1, NULL, 0 },
+        { "A-format",	1, NULL, 0 },
+        { "B-sparsity",	1, NULL, 0 },
+        { "B-format",	1, NULL, 0 },
+        { "format-sweep",	0, NULL, 0 },
         { "filename",	1, NULL, 'f' },
         { "dump",	0, NULL, 0 },
         { "binary",	0, NULL, 0 },
+        { "numa",	1, NULL, 0 },
+        { "hugepages",	1, NULL, 0 },
         { "b-ncols",	1, NULL, 'c' },
         { "b-used-ncols",	1, NULL, 'C' },
         { "b-nents-col",	1, NULL, 'E' },
         { "khops",	1, NULL, 'k' },
+        { "threads-sweep",	1, NULL, 0 },
         { "NE-chunk-size",	1, NULL, 0 },
         { "verbose",	2, NULL, 0 },
         { "no-time-A",	0, NULL, 0 },
@@ -778,8 +954,20 @@ cmdline_parser_internal (
           break;
 
         case 0:	/* Long option with no short option */
+          /* Generate A undirected and without self-loops.  */
+          if (strcmp (long_options[option_index].name, "symmetrize") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->symmetrize_flag), 0, &(args_info->symmetrize_given),
+                &(local_args_info.symmetrize_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "symmetrize", '-',
+                additional_error))
+              goto failure;
+          
+          }
           /* Run powers of the generated A matrix rather than applying A to B.  */
-          if (strcmp (long_options[option_index].name, "run-powers") == 0)
+          else if (strcmp (long_options[option_index].name, "run-powers") == 0)
           {
           
           
@@ -801,6 +989,210 @@ cmdline_parser_internal (
                 additional_error))
               goto failure;
           
+          }
+          /* Multiply with graphblas, the in-tree native CSR engine, or its C++ template kernels.  */
+          else if (strcmp (long_options[option_index].name, "backend") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->backend_arg), 
+                 &(args_info->backend_orig), &(args_info->backend_given),
+                &(local_args_info.backend_given), optarg, 0, "graphblas", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "backend", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Native engine accumulator: auto, dense, hash, heap, or bitmap.  */
+          else if (strcmp (long_options[option_index].name, "accum") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->accum_arg), 
+                 &(args_info->accum_orig), &(args_info->accum_given),
+                &(local_args_info.accum_given), optarg, 0, "auto", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "accum", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Column index width for the template kernels and binary dumps: auto, 32, or 64 (dumps: auto is 64).  */
+          else if (strcmp (long_options[option_index].name, "index-bits") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->index_bits_arg), 
+                 &(args_info->index_bits_orig), &(args_info->index_bits_given),
+                &(local_args_info.index_bits_given), optarg, 0, "auto", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "index-bits", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Also time each template hop loop through GrB_mxm.  */
+          else if (strcmp (long_options[option_index].name, "kernel-compare") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->kernel_compare_flag), 0, &(args_info->kernel_compare_given),
+                &(local_args_info.kernel_compare_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "kernel-compare", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* With b-used-ncols=1, also time each hop value on the bitmap frontier engine.  */
+          else if (strcmp (long_options[option_index].name, "single-source") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->single_source_flag), 0, &(args_info->single_source_given),
+                &(local_args_info.single_source_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "single-source", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Fraction of vertices in the frontier above which the single-source engine pulls.  */
+          else if (strcmp (long_options[option_index].name, "frontier-density") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->frontier_density_arg), 
+                 &(args_info->frontier_density_orig), &(args_info->frontier_density_given),
+                &(local_args_info.frontier_density_given), optarg, 0, "0.05", ARG_FLOAT,
+                check_ambiguity, override, 0, 0,
+                "frontier-density", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Switch to sparse-times-dense once B fills in: off, auto, or compare (also time the sparse path).  */
+          else if (strcmp (long_options[option_index].name, "spmm") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->spmm_arg), 
+                 &(args_info->spmm_orig), &(args_info->spmm_given),
+                &(local_args_info.spmm_given), optarg, 0, "off", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "spmm", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Fraction of B's entries present that triggers the switch.  */
+          else if (strcmp (long_options[option_index].name, "spmm-density") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->spmm_density_arg), 
+                 &(args_info->spmm_density_orig), &(args_info->spmm_density_given),
+                &(local_args_info.spmm_density_given), optarg, 0, "0.5", ARG_FLOAT,
+                check_ambiguity, override, 0, 0,
+                "spmm-density", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Native hop loop on A cut into L2-sized tiles: off, auto, or ROWSxCOLS.  */
+          else if (strcmp (long_options[option_index].name, "tile") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->tile_arg), 
+                 &(args_info->tile_orig), &(args_info->tile_given),
+                &(local_args_info.tile_given), optarg, 0, "off", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "tile", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Relabel vertices before the hop loop: none, degree, rcm, or community.  */
+          else if (strcmp (long_options[option_index].name, "reorder") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->reorder_arg), 
+                 &(args_info->reorder_orig), &(args_info->reorder_given),
+                &(local_args_info.reorder_given), optarg, 0, "none", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "reorder", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Storage for A (SuiteSparse): auto, hypersparse, sparse, bitmap, or full.  */
+          else if (strcmp (long_options[option_index].name, "A-sparsity") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->A_sparsity_arg), 
+                 &(args_info->A_sparsity_orig), &(args_info->A_sparsity_given),
+                &(local_args_info.A_sparsity_given), optarg, 0, "auto", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "A-sparsity", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Orientation of A (SuiteSparse): row or col.  */
+          else if (strcmp (long_options[option_index].name, "A-format") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->A_format_arg), 
+                 &(args_info->A_format_orig), &(args_info->A_format_given),
+                &(local_args_info.A_format_given), optarg, 0, "row", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "A-format", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Storage for B (SuiteSparse): auto, hypersparse, sparse, bitmap, or full.  */
+          else if (strcmp (long_options[option_index].name, "B-sparsity") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->B_sparsity_arg), 
+                 &(args_info->B_sparsity_orig), &(args_info->B_sparsity_given),
+                &(local_args_info.B_sparsity_given), optarg, 0, "auto", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "B-sparsity", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Orientation of B (SuiteSparse): row or col.  */
+          else if (strcmp (long_options[option_index].name, "B-format") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->B_format_arg), 
+                 &(args_info->B_format_orig), &(args_info->B_format_given),
+                &(local_args_info.B_format_given), optarg, 0, "row", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "B-format", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Time the hop loop over A and B storage combinations and report the fastest.  */
+          else if (strcmp (long_options[option_index].name, "format-sweep") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->format_sweep_flag), 0, &(args_info->format_sweep_given),
+                &(local_args_info.format_sweep_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "format-sweep", '-',
+                additional_error))
+              goto failure;
+          
           }
           /* Write a file to read.  */
           else if (strcmp (long_options[option_index].name, "dump") == 0)
@@ -825,6 +1217,48 @@ cmdline_parser_internal (
                 additional_error))
               goto failure;
           
+          }
+          /* NUMA placement of A: none, interleave, or partition (pins threads).  */
+          else if (strcmp (long_options[option_index].name, "numa") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->numa_arg), 
+                 &(args_info->numa_orig), &(args_info->numa_given),
+                &(local_args_info.numa_given), optarg, 0, "none", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "numa", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Back A's edge and CSR arrays with 2 MiB pages: off, thp, or explicit.  */
+          else if (strcmp (long_options[option_index].name, "hugepages") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->hugepages_arg), 
+                 &(args_info->hugepages_orig), &(args_info->hugepages_given),
+                &(local_args_info.hugepages_given), optarg, 0, "off", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "hugepages", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Rerun the hop loop at each thread count (space-delim list).  */
+          else if (strcmp (long_options[option_index].name, "threads-sweep") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->threads_sweep_arg), 
+                 &(args_info->threads_sweep_orig), &(args_info->threads_sweep_given),
+                &(local_args_info.threads_sweep_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "threads-sweep", '-',
+                additional_error))
+              goto failure;
+          
           }
           /* Number of edges to generate in a chunk..  */
           else if (strcmp (long_options[option_index].name, "NE-chunk-size") == 0)
@@ -54,10 +54,54 @@ struct gengetopt_args_info
   float noisefact_arg;	/**< @brief Noise factor on each recursion (default='0.1').  */
   char * noisefact_orig;	/**< @brief Noise factor on each recursion original value given at command line.  */
   const char *noisefact_help; /**< @brief Noise factor on each recursion help description.  */
+  int symmetrize_flag;	/**< @brief Generate A undirected and without self-loops (default=off).  */
+  const char *symmetrize_help; /**< @brief Generate A undirected and without self-loops help description.  */
   int run_powers_flag;	/**< @brief Run powers of the generated A matrix rather than applying A to B (default=off).  */
   const char *run_powers_help; /**< @brief Run powers of the generated A matrix rather than applying A to B help description.  */
   int ATA_flag;	/**< @brief Multiply A^T * A once. (default=off).  */
   const char *ATA_help; /**< @brief Multiply A^T * A once. help description.  */
+  char * backend_arg;	/**< @brief Multiply with graphblas, the in-tree native CSR engine, or its C++ template kernels (default='graphblas').  */
+  char * backend_orig;	/**< @brief Multiply with graphblas, the in-tree native CSR engine, or its C++ template kernels original value given at command line.  */
+  const char *backend_help; /**< @brief Multiply with graphblas, the in-tree native CSR engine, or its C++ template kernels help description.  */
+  char * accum_arg;	/**< @brief Native engine accumulator: auto, dense, hash, heap, or bitmap (default='auto').  */
+  char * accum_orig;	/**< @brief Native engine accumulator: auto, dense, hash, heap, or bitmap original value given at command line.  */
+  const char *accum_help; /**< @brief Native engine accumulator: auto, dense, hash, heap, or bitmap help description.  */
+  char * index_bits_arg;	/**< @brief Column index width for the template kernels and binary dumps: auto, 32, or 64 (dumps: auto is 64) (default='auto').  */
+  char * index_bits_orig;	/**< @brief Column index width for the template kernels and binary dumps: auto, 32, or 64 (dumps: auto is 64) original value given at command line.  */
+  const char *index_bits_help; /**< @brief Column index width for the template kernels and binary dumps: auto, 32, or 64 (dumps: auto is 64) help description.  */
+  int kernel_compare_flag;	/**< @brief Also time each template hop loop through GrB_mxm (default=off).  */
+  const char *kernel_compare_help; /**< @brief Also time each template hop loop through GrB_mxm help description.  */
+  int single_source_flag;	/**< @brief With b-used-ncols=1, also time each hop value on the bitmap frontier engine (default=off).  */
+  const char *single_source_help; /**< @brief With b-used-ncols=1, also time each hop value on the bitmap frontier engine help description.  */
+  float frontier_density_arg;	/**< @brief Fraction of vertices in the frontier above which the single-source engine pulls (default='0.05').  */
+  char * frontier_density_orig;	/**< @brief Fraction of vertices in the frontier above which the single-source engine pulls original value given at command line.  */
+  const char *frontier_density_help; /**< @brief Fraction of vertices in the frontier above which the single-source engine pulls help description.  */
+  char * spmm_arg;	/**< @brief Switch to sparse-times-dense once B fills in: off, auto, or compare (also time the sparse path) (default='off').  */
+  char * spmm_orig;	/**< @brief Switch to sparse-times-dense once B fills in: off, auto, or compare (also time the sparse path) original value given at command line.  */
+  const char *spmm_help; /**< @brief Switch to sparse-times-dense once B fills in: off, auto, or compare (also time the sparse path) help description.  */
+  float spmm_density_arg;	/**< @brief Fraction of B's entries present that triggers the switch (default='0.5').  */
+  char * spmm_density_orig;	/**< @brief Fraction of B's entries present that triggers the switch original value given at command line.  */
+  const char *spmm_density_help; /**< @brief Fraction of B's entries present that triggers the switch help description.  */
+  char * tile_arg;	/**< @brief Native hop loop on A cut into L2-sized tiles: off, auto, or ROWSxCOLS (default='off').  */
+  char * tile_orig;	/**< @brief Native hop loop on A cut into L2-sized tiles: off, auto, or ROWSxCOLS original value given at command line.  */
+  const char *tile_help; /**< @brief Native hop loop on A cut into L2-sized tiles: off, auto, or ROWSxCOLS help description.  */
+  char * reorder_arg;	/**< @brief Relabel vertices before the hop loop: none, degree, rcm, or community (default='none').  */
+  char * reorder_orig;	/**< @brief Relabel vertices before the hop loop: none, degree, rcm, or community original value given at command line.  */
+  const char *reorder_help; /**< @brief Relabel vertices before the hop loop: none, degree, rcm, or community help description.  */
+  char * A_sparsity_arg;	/**< @brief Storage for A (SuiteSparse): auto, hypersparse, sparse, bitmap, or full (default='auto').  */
+  char * A_sparsity_orig;	/**< @brief Storage for A (SuiteSparse): auto, hypersparse, sparse, bitmap, or full original value given at command line.  */
+  const char *A_sparsity_help; /**< @brief Storage for A (SuiteSparse): auto, hypersparse, sparse, bitmap, or full help description.  */
+  char * A_format_arg;	/**< @brief Orientation of A (SuiteSparse): row or col (default='row').  */
+  char * A_format_orig;	/**< @brief Orientation of A (SuiteSparse): row or col original value given at command line.  */
+  const char *A_format_help; /**< @brief Orientation of A (SuiteSparse): row or col help description.  */
+  char * B_sparsity_arg;	/**< @brief Storage for B (SuiteSparse): auto, hypersparse, sparse, bitmap, or full (default='auto').  */
+  char * B_sparsity_orig;	/**< @brief Storage for B (SuiteSparse): auto, hypersparse, sparse, bitmap, or full original value given at command line.  */
+  const char *B_sparsity_help; /**< @brief Storage for B (SuiteSparse): auto, hypersparse, sparse, bitmap, or full help description.  */
+  char * B_format_arg;	/**< @brief Orientation of B (SuiteSparse): row or col (default='row').  */
+  char * B_format_orig;	/**< @brief Orientation of B (SuiteSparse): row or col original value given at command line.  */
+  const char *B_format_help; /**< @brief Orientation of B (SuiteSparse): row or col help description.  */
+  int format_sweep_flag;	/**< @brief Time the hop loop over A and B storage combinations and report the fastest (default=off).  */
+  const char *format_sweep_help; /**< @brief Time the hop loop over A and B storage combinations and report the fastest help description.  */
   char * filename_arg;	/**< @brief Filename to read/write for a CSR format.  */
   char * filename_orig;	/**< @brief Filename to read/write for a CSR format original value given at command line.  */
   const char *filename_help; /**< @brief Filename to read/write for a CSR format help description.  */
@@ -65,6 +109,12 @@ struct gengetopt_args_info
   const char *dump_help; /**< @brief Write a file to read help description.  */
   int binary_flag;	/**< @brief File is in binary format (default=off).  */
   const char *binary_help; /**< @brief File is in binary format help description.  */
+  char * numa_arg;	/**< @brief NUMA placement of A: none, interleave, or partition (pins threads) (default='none').  */
+  char * numa_orig;	/**< @brief NUMA placement of A: none, interleave, or partition (pins threads) original value given at command line.  */
+  const char *numa_help; /**< @brief NUMA placement of A: none, interleave, or partition (pins threads) help description.  */
+  char * hugepages_arg;	/**< @brief Back A's edge and CSR arrays with 2 MiB pages: off, thp, or explicit (default='off').  */
+  char * hugepages_orig;	/**< @brief Back A's edge and CSR arrays with 2 MiB pages: off, thp, or explicit original value given at command line.  */
+  const char *hugepages_help; /**< @brief Back A's edge and CSR arrays with 2 MiB pages: off, thp, or explicit help description.  */
   int b_ncols_arg;	/**< @brief Number of columns in B (default='16').  */
   char * b_ncols_orig;	/**< @brief Number of columns in B original value given at command line.  */
   const char *b_ncols_help; /**< @brief Number of columns in B help description.  */
@@ -77,6 +127,9 @@ struct gengetopt_args_info
   char * khops_arg;	/**< @brief Number of iterations / hops (can be a space-delim list) (default='2 4 8').  */
   char * khops_orig;	/**< @brief Number of iterations / hops (can be a space-delim list) original value given at command line.  */
   const char *khops_help; /**< @brief Number of iterations / hops (can be a space-delim list) help description.  */
+  char * threads_sweep_arg;	/**< @brief Rerun the hop loop at each thread count (space-delim list).  */
+  char * threads_sweep_orig;	/**< @brief Rerun the hop loop at each thread count (space-delim list) original value given at command line.  */
+  const char *threads_sweep_help; /**< @brief Rerun the hop loop at each thread count (space-delim list) help description.  */
   long NE_chunk_size_arg;	/**< @brief Number of edges to generate in a chunk. (default='1048576').  */
   char * NE_chunk_size_orig;	/**< @brief Number of edges to generate in a chunk. original value given at command line.  */
   const char *NE_chunk_size_help; /**< @brief Number of edges to generate in a chunk. help description.  */
@@ -97,15 +150,34 @@ struct gengetopt_args_info
   unsigned int A_given ;	/**< @brief Whether A was given.  */
   unsigned int B_given ;	/**< @brief Whether B was given.  */
   unsigned int noisefact_given ;	/**< @brief Whether noisefact was given.  */
+  unsigned int symmetrize_given ;	/**< @brief Whether symmetrize was given.  */
   unsigned int run_powers_given ;	/**< @brief Whether run-powers was given.  */
   unsigned int ATA_given ;	/**< @brief Whether ATA was given.  */
+  unsigned int backend_given ;	/**< @brief Whether backend was given.  */
+  unsigned int accum_given ;	/**< @brief Whether accum was given.  */
+  unsigned int index_bits_given ;	/**< @brief Whether index-bits was given.  */
+  unsigned int kernel_compare_given ;	/**< @brief Whether kernel-compare was given.  */
+  unsigned int single_source_given ;	/**< @brief Whether single-source was given.  */
+  unsigned int frontier_density_given ;	/**< @brief Whether frontier-density was given.  */
+  unsigned int spmm_given ;	/**< @brief Whether spmm was given.  */
+  unsigned int spmm_density_given ;	/**< @brief Whether spmm-density was given.  */
+  unsigned int tile_given ;	/**< @brief Whether tile was given.  */
+  unsigned int reorder_given ;	/**< @brief Whether reorder was given.  */
+  unsigned int A_sparsity_given ;	/**< @brief Whether A-sparsity was given.  */
+  unsigned int A_format_given ;	/**< @brief Whether A-format was given.  */
+  unsigned int B_sparsity_given ;	/**< @brief Whether B-sparsity was given.  */
+  unsigned int B_format_given ;	/**< @brief Whether B-format was given.  */
+  unsigned int format_sweep_given ;	/**< @brief Whether format-sweep was given.  */
   unsigned int filename_given ;	/**< @brief Whether filename was given.  */
   unsigned int dump_given ;	/**< @brief Whether dump was given.  */
   unsigned int binary_given ;	/**< @brief Whether binary was given.  */
+  unsigned int numa_given ;	/**< @brief Whether numa was given.  */
+  unsigned int hugepages_given ;	/**< @brief Whether hugepages was given.  */
   unsigned int b_ncols_given ;	/**< @brief Whether b-ncols was given.  */
   unsigned int b_used_ncols_given ;	/**< @brief Whether b-used-ncols was given.  */
   unsigned int b_nents_col_given ;	/**< @brief Whether b-nents-col was given.  */
   unsigned int khops_given ;	/**< @brief Whether khops was given.  */
+  unsigned int threads_sweep_given ;	/**< @brief Whether threads-sweep was given.  */
   unsigned int NE_chunk_size_given ;	/**< @brief Whether NE-chunk-size was given.  */
   unsigned int verbose_given ;	/**< @brief Whether verbose was given.  */
   unsigned int no_time_A_given ;	/**< @brief Whether no-time-A was given.  */
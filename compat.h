@@ -36,11 +36,17 @@ typedef unsigned uint32_fast_t;
 #if defined(__GNUC__)
 static int omp_get_thread_num (void) __attribute__((unused));
 static int omp_get_num_threads (void) __attribute__((unused));
+static int omp_get_max_threads (void) __attribute__((unused));
+static void omp_set_num_threads (int) __attribute__((unused));
 int omp_get_thread_num (void) { return 0; }
 int omp_get_num_threads (void) { return 1; }
+int omp_get_max_threads (void) { return 1; }
+void omp_set_num_threads (int n) { (void)n; }
 #else
 static int omp_get_thread_num (void) { return 0; }
 static int omp_get_num_threads (void) { return 1; }
+static int omp_get_max_threads (void) { return 1; }
+static void omp_set_num_threads (int n) { (void)n; }
 #endif
 #else
 #define OMP_(x) _Pragma(#x)
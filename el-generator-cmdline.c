@@ -45,7 +45,24 @@ const char *gengetopt_args_info_help[] = {
   "",
   "  -f, --filename=STRING     Filename for the edge list, - for stdout",
   "  -b, --binary              File is in binary format  (default=off)",
+  "      --index-bits=INT      Bits per vertex id in the binary list: 64 (el64) or\n                              32 (el32)  (default=`64')",
+  "      --weights             With --binary, write (i, j, w) triples of 64-bit\n                              values (wel64)  (default=off)",
   "      --neo4j               Output the CSV Neo4J expects  (default=off)",
+  "      --shards=INT          Write the list as this many shards in parallel,\n                              each to filename.N, plus filename.manifest (0:\n                              one stream)  (default=`0')",
+  "      --shard-file          With --shards and --binary, write the shards to\n                              disjoint ranges of filename itself  (default=off)",
+  "      --sorted              Write the list symmetrized, sorted by (i, j),\n                              deduplicated, and without self-loops (el32 or\n                              el64)  (default=off)",
+  "      --sort-memory=LONG    MiB the in-memory sort may use before spilling\n                              buckets to disk (0: half of physical memory)\n                              (default=`0')",
+  "      --sort-tmpdir=STRING  Directory for the sort's spilled buckets\n                              (default=`.')",
+  "      --compress=STRING     Compress the list (and each shard) as it is\n                              written: none or gzip  (default=`none')",
+  "      --pipeline            Write each chunk while generating the next, and\n                              report the overlap  (default=off)",
+  "      --direct              With --pipeline, write the file with O_DIRECT\n                              (default=off)",
+  "      --edge-range=STRING   Generate only edges begin:end of the list (end may\n                              be left empty for the last edge)",
+  "      --resume              With --binary and a --filename, keep the edges an\n                              interrupted run already wrote and generate the\n                              rest  (default=off)",
+  "      --checksum            With --binary and a --filename, write the edges'\n                              checksum to filename.sum  (default=off)",
+  "      --nranks=INT          Split the chunks among this many processes, rank r\n                              writing filename.r (0: one process)\n                              (default=`0')",
+  "      --rank=INT            With --nranks, this process's rank (default: from\n                              OMPI_COMM_WORLD_RANK or PMI_RANK)",
+  "      --launch              With --nranks, run every rank as a local process,\n                              then merge  (default=off)",
+  "      --merge               With --nranks, merge the ranks' files into\n                              filename, checking their checksums  (default=off)",
   "",
   "      --NE-chunk-size=LONG  Number of edges to generate in a chunk.\n                              (default=`1048576')",
   "      --verbose[=INT]       Provide status updates via stdout.  (default=`1')",
@@ -86,7 +103,24 @@ void clear_given (struct gengetopt_args_info *args_info)
   args_info->tree_given = 0 ;
   args_info->filename_given = 0 ;
   args_info->binary_given = 0 ;
+  args_info->index_bits_given = 0 ;
+  args_info->weights_given = 0 ;
   args_info->neo4j_given = 0 ;
+  args_info->shards_given = 0 ;
+  args_info->shard_file_given = 0 ;
+  args_info->sorted_given = 0 ;
+  args_info->sort_memory_given = 0 ;
+  args_info->sort_tmpdir_given = 0 ;
+  args_info->compress_given = 0 ;
+  args_info->pipeline_given = 0 ;
+  args_info->direct_given = 0 ;
+  args_info->edge_range_given = 0 ;
+  args_info->resume_given = 0 ;
+  args_info->checksum_given = 0 ;
+  args_info->nranks_given = 0 ;
+  args_info->rank_given = 0 ;
+  args_info->launch_given = 0 ;
+  args_info->merge_given = 0 ;
   args_info->NE_chunk_size_given = 0 ;
   args_info->verbose_given = 0 ;
 }
@@ -109,7 +143,31 @@ void clear_args (struct gengetopt_args_info *args_info)
   args_info->filename_arg = NULL;
   args_info->filename_orig = NULL;
   args_info->binary_flag = 0;
+  args_info->index_bits_arg = 64;
+  args_info->index_bits_orig = NULL;
+  args_info->weights_flag = 0;
   args_info->neo4j_flag = 0;
+  args_info->shards_arg = 0;
+  args_info->shards_orig = NULL;
+  args_info->shard_file_flag = 0;
+  args_info->sorted_flag = 0;
+  args_info->sort_memory_arg = 0;
+  args_info->sort_memory_orig = NULL;
+  args_info->sort_tmpdir_arg = gengetopt_strdup (".");
+  args_info->sort_tmpdir_orig = NULL;
+  args_info->compress_arg = gengetopt_strdup ("none");
+  args_info->compress_orig = NULL;
+  args_info->pipeline_flag = 0;
+  args_info->direct_flag = 0;
+  args_info->edge_range_arg = NULL;
+  args_info->edge_range_orig = NULL;
+  args_info->resume_flag = 0;
+  args_info->checksum_flag = 0;
+  args_info->nranks_arg = 0;
+  args_info->nranks_orig = NULL;
+  args_info->rank_orig = NULL;
+  args_info->launch_flag = 0;
+  args_info->merge_flag = 0;
   args_info->NE_chunk_size_arg = 1048576;
   args_info->NE_chunk_size_orig = NULL;
   args_info->verbose_arg = 1;
@@ -132,9 +190,26 @@ void init_args_info(struct gengetopt_args_info *args_info)
   args_info->tree_help = gengetopt_args_info_help[7] ;
   args_info->filename_help = gengetopt_args_info_help[9] ;
   args_info->binary_help = gengetopt_args_info_help[10] ;
-  args_info->neo4j_help = gengetopt_args_info_help[11] ;
-  args_info->NE_chunk_size_help = gengetopt_args_info_help[13] ;
-  args_info->verbose_help = gengetopt_args_info_help[14] ;
+  args_info->index_bits_help = gengetopt_args_info_help[11] ;
+  args_info->weights_help = gengetopt_args_info_help[12] ;
+  args_info->neo4j_help = gengetopt_args_info_help[13] ;
+  args_info->shards_help = gengetopt_args_info_help[14] ;
+  args_info->shard_file_help = gengetopt_args_info_help[15] ;
+  args_info->sorted_help = gengetopt_args_info_help[16] ;
+  args_info->sort_memory_help = gengetopt_args_info_help[17] ;
+  args_info->sort_tmpdir_help = gengetopt_args_info_help[18] ;
+  args_info->compress_help = gengetopt_args_info_help[19] ;
+  args_info->pipeline_help = gengetopt_args_info_help[20] ;
+  args_info->direct_help = gengetopt_args_info_help[21] ;
+  args_info->edge_range_help = gengetopt_args_info_help[22] ;
+  args_info->resume_help = gengetopt_args_info_help[23] ;
+  args_info->checksum_help = gengetopt_args_info_help[24] ;
+  args_info->nranks_help = gengetopt_args_info_help[25] ;
+  args_info->rank_help = gengetopt_args_info_help[26] ;
+  args_info->launch_help = gengetopt_args_info_help[27] ;
+  args_info->merge_help = gengetopt_args_info_help[28] ;
+  args_info->NE_chunk_size_help = gengetopt_args_info_help[30] ;
+  args_info->verbose_help = gengetopt_args_info_help[31] ;
   
 }
 
@@ -231,6 +306,17 @@ cmdline_parser_release (struct gengetopt_args_info *args_info)
   free_string_field (&(args_info->noisefact_orig));
   free_string_field (&(args_info->filename_arg));
   free_string_field (&(args_info->filename_orig));
+  free_string_field (&(args_info->index_bits_orig));
+  free_string_field (&(args_info->shards_orig));
+  free_string_field (&(args_info->sort_memory_orig));
+  free_string_field (&(args_info->sort_tmpdir_arg));
+  free_string_field (&(args_info->sort_tmpdir_orig));
+  free_string_field (&(args_info->compress_arg));
+  free_string_field (&(args_info->compress_orig));
+  free_string_field (&(args_info->edge_range_arg));
+  free_string_field (&(args_info->edge_range_orig));
+  free_string_field (&(args_info->nranks_orig));
+  free_string_field (&(args_info->rank_orig));
   free_string_field (&(args_info->NE_chunk_size_orig));
   free_string_field (&(args_info->verbose_orig));
   
@@ -283,8 +369,42 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
     write_into_file(outfile, "filename", args_info->filename_orig, 0);
   if (args_info->binary_given)
     write_into_file(outfile, "binary", 0, 0 );
+  if (args_info->index_bits_given)
+    write_into_file(outfile, "index-bits", args_info->index_bits_orig, 0);
+  if (args_info->weights_given)
+    write_into_file(outfile, "weights", 0, 0 );
   if (args_info->neo4j_given)
     write_into_file(outfile, "neo4j", 0, 0 );
+  if (args_info->shards_given)
+    write_into_file(outfile, "shards", args_info->shards_orig, 0);
+  if (args_info->shard_file_given)
+    write_into_file(outfile, "shard-file", 0, 0 );
+  if (args_info->sorted_given)
+    write_into_file(outfile, "sorted", 0, 0 );
+  if (args_info->sort_memory_given)
+    write_into_file(outfile, "sort-memory", args_info->sort_memory_orig, 0);
+  if (args_info->sort_tmpdir_given)
+    write_into_file(outfile, "sort-tmpdir", args_info->sort_tmpdir_orig, 0);
+  if (args_info->compress_given)
+    write_into_file(outfile, "compress", args_info->compress_orig, 0);
+  if (args_info->pipeline_given)
+    write_into_file(outfile, "pipeline", 0, 0 );
+  if (args_info->direct_given)
+    write_into_file(outfile, "direct", 0, 0 );
+  if (args_info->edge_range_given)
+    write_into_file(outfile, "edge-range", args_info->edge_range_orig, 0);
+  if (args_info->resume_given)
+    write_into_file(outfile, "resume", 0, 0 );
+  if (args_info->checksum_given)
+    write_into_file(outfile, "checksum", 0, 0 );
+  if (args_info->nranks_given)
+    write_into_file(outfile, "nranks", args_info->nranks_orig, 0);
+  if (args_info->rank_given)
+    write_into_file(outfile, "rank", args_info->rank_orig, 0);
+  if (args_info->launch_given)
+    write_into_file(outfile, "launch", 0, 0 );
+  if (args_info->merge_given)
+    write_into_file(outfile, "merge", 0, 0 );
   if (args_info->NE_chunk_size_given)
     write_into_file(outfile, "NE-chunk-size", args_info->NE_chunk_size_orig, 0);
   if (args_info->verbose_given)
@@ -567,7 +687,24 @@ cmdline_parser_internal (
         { "tree",	0, NULL, 'T' },
         { "filename",	1, NULL, 'f' },
         { "binary",	0, NULL, 'b' },
+        { "index-bits",	1, NULL, 0 },
+        { "weights",	0, NULL, 0 },
         { "neo4j",	0, NULL, 0 },
+        { "shards",	1, NULL, 0 },
+        { "shard-file",	0, NULL, 0 },
+        { "sorted",	0, NULL, 0 },
+        { "sort-memory",	1, NULL, 0 },
+        { "sort-tmpdir",	1, NULL, 0 },
+        { "compress",	1, NULL, 0 },
+        { "pipeline",	0, NULL, 0 },
+        { "direct",	0, NULL, 0 },
+        { "edge-range",	1, NULL, 0 },
+        { "resume",	0, NULL, 0 },
+        { "checksum",	0, NULL, 0 },
+        { "nranks",	1, NULL, 0 },
+        { "rank",	1, NULL, 0 },
+        { "launch",	0, NULL, 0 },
+        { "merge",	0, NULL, 0 },
         { "NE-chunk-size",	1, NULL, 0 },
         { "verbose",	2, NULL, 0 },
         { 0,  0, 0, 0 }
@@ -683,8 +820,34 @@ cmdline_parser_internal (
           break;
 
         case 0:	/* Long option with no short option */
+          /* Bits per vertex id in the binary list: 64 (el64) or 32 (el32).  */
+          if (strcmp (long_options[option_index].name, "index-bits") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->index_bits_arg), 
+                 &(args_info->index_bits_orig), &(args_info->index_bits_given),
+                &(local_args_info.index_bits_given), optarg, 0, "64", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "index-bits", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* With --binary, write (i, j, w) triples of 64-bit values (wel64).  */
+          else if (strcmp (long_options[option_index].name, "weights") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->weights_flag), 0, &(args_info->weights_given),
+                &(local_args_info.weights_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "weights", '-',
+                additional_error))
+              goto failure;
+          
+          }
           /* Output the CSV Neo4J expects.  */
-          if (strcmp (long_options[option_index].name, "neo4j") == 0)
+          else if (strcmp (long_options[option_index].name, "neo4j") == 0)
           {
           
           
@@ -694,6 +857,200 @@ cmdline_parser_internal (
                 additional_error))
               goto failure;
           
+          }
+          /* Write the list as this many shards in parallel, each to filename.N, plus filename.manifest (0: one stream).  */
+          else if (strcmp (long_options[option_index].name, "shards") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->shards_arg), 
+                 &(args_info->shards_orig), &(args_info->shards_given),
+                &(local_args_info.shards_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "shards", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* With --shards and --binary, write the shards to disjoint ranges of filename itself.  */
+          else if (strcmp (long_options[option_index].name, "shard-file") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->shard_file_flag), 0, &(args_info->shard_file_given),
+                &(local_args_info.shard_file_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "shard-file", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Write the list symmetrized, sorted by (i, j), deduplicated, and without self-loops (el32 or el64).  */
+          else if (strcmp (long_options[option_index].name, "sorted") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->sorted_flag), 0, &(args_info->sorted_given),
+                &(local_args_info.sorted_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "sorted", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* MiB the in-memory sort may use before spilling buckets to disk (0: half of physical memory).  */
+          else if (strcmp (long_options[option_index].name, "sort-memory") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->sort_memory_arg), 
+                 &(args_info->sort_memory_orig), &(args_info->sort_memory_given),
+                &(local_args_info.sort_memory_given), optarg, 0, "0", ARG_LONG,
+                check_ambiguity, override, 0, 0,
+                "sort-memory", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Directory for the sort's spilled buckets.  */
+          else if (strcmp (long_options[option_index].name, "sort-tmpdir") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->sort_tmpdir_arg), 
+                 &(args_info->sort_tmpdir_orig), &(args_info->sort_tmpdir_given),
+                &(local_args_info.sort_tmpdir_given), optarg, 0, ".", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "sort-tmpdir", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Compress the list (and each shard) as it is written: none or gzip.  */
+          else if (strcmp (long_options[option_index].name, "compress") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->compress_arg), 
+                 &(args_info->compress_orig), &(args_info->compress_given),
+                &(local_args_info.compress_given), optarg, 0, "none", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "compress", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Write each chunk while generating the next, and report the overlap.  */
+          else if (strcmp (long_options[option_index].name, "pipeline") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->pipeline_flag), 0, &(args_info->pipeline_given),
+                &(local_args_info.pipeline_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "pipeline", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* With --pipeline, write the file with O_DIRECT.  */
+          else if (strcmp (long_options[option_index].name, "direct") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->direct_flag), 0, &(args_info->direct_given),
+                &(local_args_info.direct_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "direct", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Generate only edges begin:end of the list (end may be left empty for the last edge).  */
+          else if (strcmp (long_options[option_index].name, "edge-range") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->edge_range_arg), 
+                 &(args_info->edge_range_orig), &(args_info->edge_range_given),
+                &(local_args_info.edge_range_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "edge-range", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* With --binary and a --filename, keep the edges an interrupted run already wrote and generate the rest.  */
+          else if (strcmp (long_options[option_index].name, "resume") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->resume_flag), 0, &(args_info->resume_given),
+                &(local_args_info.resume_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "resume", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* With --binary and a --filename, write the edges' checksum to filename.sum.  */
+          else if (strcmp (long_options[option_index].name, "checksum") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->checksum_flag), 0, &(args_info->checksum_given),
+                &(local_args_info.checksum_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "checksum", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Split the chunks among this many processes, rank r writing filename.r (0: one process).  */
+          else if (strcmp (long_options[option_index].name, "nranks") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->nranks_arg), 
+                 &(args_info->nranks_orig), &(args_info->nranks_given),
+                &(local_args_info.nranks_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "nranks", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* With --nranks, this process's rank (default: from OMPI_COMM_WORLD_RANK or PMI_RANK).  */
+          else if (strcmp (long_options[option_index].name, "rank") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->rank_arg), 
+                 &(args_info->rank_orig), &(args_info->rank_given),
+                &(local_args_info.rank_given), optarg, 0, 0, ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "rank", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* With --nranks, run every rank as a local process, then merge.  */
+          else if (strcmp (long_options[option_index].name, "launch") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->launch_flag), 0, &(args_info->launch_given),
+                &(local_args_info.launch_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "launch", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* With --nranks, merge the ranks' files into filename, checking their checksums.  */
+          else if (strcmp (long_options[option_index].name, "merge") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->merge_flag), 0, &(args_info->merge_given),
+                &(local_args_info.merge_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "merge", '-',
+                additional_error))
+              goto failure;
+          
           }
           /* Number of edges to generate in a chunk..  */
           else if (strcmp (long_options[option_index].name, "NE-chunk-size") == 0)
@@ -61,8 +61,50 @@ struct gengetopt_args_info
   const char *filename_help; /**< @brief Filename for the edge list, - for stdout help description.  */
   int binary_flag;	/**< @brief File is in binary format (default=off).  */
   const char *binary_help; /**< @brief File is in binary format help description.  */
+  int index_bits_arg;	/**< @brief Bits per vertex id in the binary list: 64 (el64) or 32 (el32) (default='64').  */
+  char * index_bits_orig;	/**< @brief Bits per vertex id in the binary list: 64 (el64) or 32 (el32) original value given at command line.  */
+  const char *index_bits_help; /**< @brief Bits per vertex id in the binary list: 64 (el64) or 32 (el32) help description.  */
+  int weights_flag;	/**< @brief With --binary, write (i, j, w) triples of 64-bit values (wel64) (default=off).  */
+  const char *weights_help; /**< @brief With --binary, write (i, j, w) triples of 64-bit values (wel64) help description.  */
   int neo4j_flag;	/**< @brief Output the CSV Neo4J expects (default=off).  */
   const char *neo4j_help; /**< @brief Output the CSV Neo4J expects help description.  */
+  int shards_arg;	/**< @brief Write the list as this many shards in parallel, each to filename.N, plus filename.manifest (0: one stream) (default='0').  */
+  char * shards_orig;	/**< @brief Write the list as this many shards in parallel, each to filename.N, plus filename.manifest (0: one stream) original value given at command line.  */
+  const char *shards_help; /**< @brief Write the list as this many shards in parallel, each to filename.N, plus filename.manifest (0: one stream) help description.  */
+  int shard_file_flag;	/**< @brief With --shards and --binary, write the shards to disjoint ranges of filename itself (default=off).  */
+  const char *shard_file_help; /**< @brief With --shards and --binary, write the shards to disjoint ranges of filename itself help description.  */
+  int sorted_flag;	/**< @brief Write the list symmetrized, sorted by (i, j), deduplicated, and without self-loops (el32 or el64) (default=off).  */
+  const char *sorted_help; /**< @brief Write the list symmetrized, sorted by (i, j), deduplicated, and without self-loops (el32 or el64) help description.  */
+  long sort_memory_arg;	/**< @brief MiB the in-memory sort may use before spilling buckets to disk (0: half of physical memory) (default='0').  */
+  char * sort_memory_orig;	/**< @brief MiB the in-memory sort may use before spilling buckets to disk (0: half of physical memory) original value given at command line.  */
+  const char *sort_memory_help; /**< @brief MiB the in-memory sort may use before spilling buckets to disk (0: half of physical memory) help description.  */
+  char * sort_tmpdir_arg;	/**< @brief Directory for the sort's spilled buckets (default='.').  */
+  char * sort_tmpdir_orig;	/**< @brief Directory for the sort's spilled buckets original value given at command line.  */
+  const char *sort_tmpdir_help; /**< @brief Directory for the sort's spilled buckets help description.  */
+  char * compress_arg;	/**< @brief Compress the list (and each shard) as it is written: none or gzip (default='none').  */
+  char * compress_orig;	/**< @brief Compress the list (and each shard) as it is written: none or gzip original value given at command line.  */
+  const char *compress_help; /**< @brief Compress the list (and each shard) as it is written: none or gzip help description.  */
+  int pipeline_flag;	/**< @brief Write each chunk while generating the next, and report the overlap (default=off).  */
+  const char *pipeline_help; /**< @brief Write each chunk while generating the next, and report the overlap help description.  */
+  int direct_flag;	/**< @brief With --pipeline, write the file with O_DIRECT (default=off).  */
+  const char *direct_help; /**< @brief With --pipeline, write the file with O_DIRECT help description.  */
+  char * edge_range_arg;	/**< @brief Generate only edges begin:end of the list (end may be left empty for the last edge).  */
+  char * edge_range_orig;	/**< @brief Generate only edges begin:end of the list (end may be left empty for the last edge) original value given at command line.  */
+  const char *edge_range_help; /**< @brief Generate only edges begin:end of the list (end may be left empty for the last edge) help description.  */
+  int resume_flag;	/**< @brief With --binary and a --filename, keep the edges an interrupted run already wrote and generate the rest (default=off).  */
+  const char *resume_help; /**< @brief With --binary and a --filename, keep the edges an interrupted run already wrote and generate the rest help description.  */
+  int checksum_flag;	/**< @brief With --binary and a --filename, write the edges' checksum to filename.sum (default=off).  */
+  const char *checksum_help; /**< @brief With --binary and a --filename, write the edges' checksum to filename.sum help description.  */
+  int nranks_arg;	/**< @brief Split the chunks among this many processes, rank r writing filename.r (0: one process) (default='0').  */
+  char * nranks_orig;	/**< @brief Split the chunks among this many processes, rank r writing filename.r (0: one process) original value given at command line.  */
+  const char *nranks_help; /**< @brief Split the chunks among this many processes, rank r writing filename.r (0: one process) help description.  */
+  int rank_arg;	/**< @brief With --nranks, this process's rank (default: from OMPI_COMM_WORLD_RANK or PMI_RANK).  */
+  char * rank_orig;	/**< @brief With --nranks, this process's rank (default: from OMPI_COMM_WORLD_RANK or PMI_RANK) original value given at command line.  */
+  const char *rank_help; /**< @brief With --nranks, this process's rank (default: from OMPI_COMM_WORLD_RANK or PMI_RANK) help description.  */
+  int launch_flag;	/**< @brief With --nranks, run every rank as a local process, then merge (default=off).  */
+  const char *launch_help; /**< @brief With --nranks, run every rank as a local process, then merge help description.  */
+  int merge_flag;	/**< @brief With --nranks, merge the ranks' files into filename, checking their checksums (default=off).  */
+  const char *merge_help; /**< @brief With --nranks, merge the ranks' files into filename, checking their checksums help description.  */
   long NE_chunk_size_arg;	/**< @brief Number of edges to generate in a chunk. (default='1048576').  */
   char * NE_chunk_size_orig;	/**< @brief Number of edges to generate in a chunk. original value given at command line.  */
   const char *NE_chunk_size_help; /**< @brief Number of edges to generate in a chunk. help description.  */
@@ -80,7 +122,24 @@ struct gengetopt_args_info
   unsigned int tree_given ;	/**< @brief Whether tree was given.  */
   unsigned int filename_given ;	/**< @brief Whether filename was given.  */
   unsigned int binary_given ;	/**< @brief Whether binary was given.  */
+  unsigned int index_bits_given ;	/**< @brief Whether index-bits was given.  */
+  unsigned int weights_given ;	/**< @brief Whether weights was given.  */
   unsigned int neo4j_given ;	/**< @brief Whether neo4j was given.  */
+  unsigned int shards_given ;	/**< @brief Whether shards was given.  */
+  unsigned int shard_file_given ;	/**< @brief Whether shard-file was given.  */
+  unsigned int sorted_given ;	/**< @brief Whether sorted was given.  */
+  unsigned int sort_memory_given ;	/**< @brief Whether sort-memory was given.  */
+  unsigned int sort_tmpdir_given ;	/**< @brief Whether sort-tmpdir was given.  */
+  unsigned int compress_given ;	/**< @brief Whether compress was given.  */
+  unsigned int pipeline_given ;	/**< @brief Whether pipeline was given.  */
+  unsigned int direct_given ;	/**< @brief Whether direct was given.  */
+  unsigned int edge_range_given ;	/**< @brief Whether edge-range was given.  */
+  unsigned int resume_given ;	/**< @brief Whether resume was given.  */
+  unsigned int checksum_given ;	/**< @brief Whether checksum was given.  */
+  unsigned int nranks_given ;	/**< @brief Whether nranks was given.  */
+  unsigned int rank_given ;	/**< @brief Whether rank was given.  */
+  unsigned int launch_given ;	/**< @brief Whether launch was given.  */
+  unsigned int merge_given ;	/**< @brief Whether merge was given.  */
   unsigned int NE_chunk_size_given ;	/**< @brief Whether NE-chunk-size was given.  */
   unsigned int verbose_given ;	/**< @brief Whether verbose was given.  */
 
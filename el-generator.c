@@ -1,16 +1,26 @@
 /* -*- C -*- */
-#define _POSIX_SOURCE
+#define _GNU_SOURCE  // O_DIRECT
+#include "compat.h"
+
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
 #include <unistd.h>
 
-#include "compat.h"
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
 #include "el-generator-cmdline.h"
+#include "elsort.h"
 #include "generator.h"  // for make_edge
 #include "globals.h"
 #include "prng.h"  // for sample_roots
@@ -19,6 +29,868 @@ int verbose = 0;
 
 struct gengetopt_args_info args;
 
+// Shard buffers are aligned for the block layer.
+#define OUT_ALIGN 4096
+// Longest text line: two 20-digit ids, a weight or "EDGE,", separators.
+#define TEXT_LINE_MAX 64
+
+static double wall_ms(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return 1.0e3 * t.tv_sec + 1.0e-6 * t.tv_nsec;
+}
+
+// Write all of buf at off, or at the file position if off < 0.
+static void write_all(int fd, const char *buf, size_t len, off_t off) {
+  while (len) {
+    const ssize_t n = off < 0 ? write(fd, buf, len) : pwrite(fd, buf, len, off);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) DIE_PERROR("Error writing edge list: ");
+    buf += n;
+    len -= n;
+    if (off >= 0) off += n;
+  }
+}
+
+/* Where a stream of the list goes: fd itself, or through gzip when
+   compressing.  The gzip stream is deflated by the writing thread, so
+   only shards compress in parallel. */
+struct sink {
+  int fd;
+#if defined(HAVE_ZLIB)
+  gzFile gz;
+#endif
+};
+
+static void sink_open(struct sink *out, int fd, int compress) {
+  out->fd = fd;
+#if defined(HAVE_ZLIB)
+  out->gz = NULL;
+  if (compress) {
+    // Fastest level: the point is to keep up with the generator.
+    // gzclose closes its descriptor; keep stdout open.
+    out->gz = gzdopen(fd == STDOUT_FILENO ? dup(fd) : fd, "wb1");
+    if (!out->gz) DIE_PERROR("Cannot start gzip stream: ");
+    gzbuffer(out->gz, 1 << 20);
+  }
+#else
+  if (compress) DIE("This el-generator was built without zlib\n");
+#endif
+}
+
+static void sink_write(struct sink *out, const char *buf, size_t len) {
+#if defined(HAVE_ZLIB)
+  if (out->gz) {
+    while (len) {
+      const unsigned n = len > (1u << 30) ? 1u << 30 : (unsigned)len;
+      if (gzwrite(out->gz, buf, n) != (int)n)
+        DIE("Error compressing edge list\n");
+      buf += n;
+      len -= n;
+    }
+    return;
+  }
+#endif
+  write_all(out->fd, buf, len, -1);
+}
+
+// Closes the file descriptor too, unless it is stdout.
+static void sink_close(struct sink *out) {
+#if defined(HAVE_ZLIB)
+  if (out->gz) {
+    if (gzclose(out->gz) != Z_OK) DIE("Error finishing gzip stream\n");
+    return;
+  }
+#endif
+  if (out->fd != STDOUT_FILENO && close(out->fd))
+    DIE_PERROR("Error closing edge list: ");
+}
+
+static void *aligned_malloc(size_t len) {
+  void *p = NULL;
+  if (posix_memalign(&p, OUT_ALIGN, len ? len : 1)) return NULL;
+  return p;
+}
+
+// Output formats.  el32 and el64 are (i, j) pairs of 32- and 64-bit
+// ids, wel64 (i, j, w) triples of 64-bit values.
+enum el_format { EL_TEXT = 0, EL_32, EL_64, EL_W64 };
+
+static const char *el_format_name(enum el_format fmt) {
+  switch (fmt) {
+    case EL_32:
+      return "el32";
+    case EL_64:
+      return "el64";
+    case EL_W64:
+      return "wel64";
+    default:
+      return "text";
+  }
+}
+
+// Bytes per edge in a binary format, 0 for text.
+static size_t el_edge_bytes(enum el_format fmt) {
+  switch (fmt) {
+    case EL_32:
+      return 2 * sizeof(uint32_t);
+    case EL_64:
+      return 2 * sizeof(int64_t);
+    case EL_W64:
+      return 3 * sizeof(int64_t);
+    default:
+      return 0;
+  }
+}
+
+// The binary header, also written at the top of each shard file.
+static int format_header(char *buf, size_t cap, enum el_format fmt,
+                         int64_t ne, const uint64_t seeds[4]) {
+  return snprintf(buf, cap,
+                  "--format %s --num_edges %ld --num_vertices %ld "
+                  "--is_undirected --seed0 %lu --seed1 %lu --seed2 %lu "
+                  "--seed3 %lu",
+                  el_format_name(fmt), (long)ne, (long)NV, seeds[0],
+                  seeds[1], seeds[2], seeds[3]);
+}
+
+/* The binary header for edges [begin, end), newline included.  A
+   rank's file reads like a shard's; any other range that is not the
+   whole list adds just --edge_begin.  With fp, the fingerprint comes
+   last, EDGE_FINGERPRINT_LEN characters ahead of the newline, so it
+   can be filled in once the edges are written. */
+static int range_header(char *buf, size_t cap, enum el_format fmt,
+                        const uint64_t seeds[4], int64_t begin, int64_t end,
+                        int rank, int nranks,
+                        const struct edge_fingerprint *fp) {
+  int len = format_header(buf, cap - 1, fmt, end - begin, seeds);
+  if (rank >= 0)
+    len += snprintf(buf + len, cap - 1 - len, " --edge_begin %ld --shard %d/%d",
+                    (long)begin, rank, nranks);
+  else if (begin != 0 || end != NE)
+    len += snprintf(buf + len, cap - 1 - len, " --edge_begin %ld", (long)begin);
+  if (fp)
+    len += snprintf(buf + len, cap - 1 - len,
+                    " --fingerprint " EDGE_FINGERPRINT_FMT, fp->multiset,
+                    fp->ordered);
+  buf[len++] = '\n';
+  return len;
+}
+
+struct chunk_buffers {
+  int64_t *el;     // el64 pairs, or (i, j, w) triples for wel64 and text
+  uint32_t *el_32; // el32 pairs
+  char *text;      // TEXT_LINE_MAX bytes per edge
+  size_t *text_len; // per text block
+  int ntext;
+};
+
+static const char digit_pairs[201] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+// v in decimal at p, two digits per table lookup; returns the end.
+static inline char *put_u64(char *p, uint64_t v) {
+  char tmp[20], *t = tmp + sizeof(tmp);
+  while (v >= 100) {
+    t -= 2;
+    memcpy(t, &digit_pairs[2 * (v % 100)], 2);
+    v /= 100;
+  }
+  if (v >= 10) {
+    t -= 2;
+    memcpy(t, &digit_pairs[2 * v], 2);
+  } else
+    *--t = '0' + v;
+  const size_t n = tmp + sizeof(tmp) - t;
+  memcpy(p, t, n);
+  return p + n;
+}
+
+/* Format (i, j, w) triples el[0..ne) as text lines, in order.  Each
+   thread formats a contiguous block of edges into its own stretch of
+   text, sized for the longest lines; the blocks are then packed down.
+   Returns the length. */
+static size_t format_text(char *restrict text, size_t *restrict block_len,
+                          int nblock, const int64_t *restrict el,
+                          int64_t ne) {
+  const int neo4j = args.neo4j_flag;
+  OMP(parallel for schedule(static, 1))
+  for (int t = 0; t < nblock; ++t) {
+    const int64_t k0 = ne * t / nblock, k1 = ne * (t + 1) / nblock;
+    char *const start = text + k0 * TEXT_LINE_MAX;
+    char *p = start;
+    for (int64_t k = k0; k < k1; ++k) {
+      if (neo4j) {
+        memcpy(p, "EDGE,", 5);
+        p = put_u64(p + 5, el[3 * k]);
+        *p++ = ',';
+        p = put_u64(p, el[1 + 3 * k]);
+      } else {
+        p = put_u64(p, el[3 * k]);
+        *p++ = '\t';
+        p = put_u64(p, el[1 + 3 * k]);
+        *p++ = '\t';
+        p = put_u64(p, el[2 + 3 * k]);
+      }
+      *p++ = '\n';
+    }
+    block_len[t] = p - start;
+  }
+  size_t len = block_len[0];
+  for (int t = 1; t < nblock; ++t) {
+    memmove(text + len, text + (ne * t / nblock) * TEXT_LINE_MAX,
+            block_len[t]);
+    len += block_len[t];
+  }
+  return len;
+}
+
+// Aligned buffers for chunks of up to NE_chunk_size edges.
+static void alloc_chunk_buffers(struct chunk_buffers *b, enum el_format fmt,
+                                size_t NE_chunk_size) {
+  memset(b, 0, sizeof(*b));
+  if (fmt == EL_32)
+    b->el_32 = aligned_malloc(2 * NE_chunk_size * sizeof(*b->el_32));
+  else
+    b->el = aligned_malloc((fmt == EL_64 ? 2 : 3) * NE_chunk_size *
+                           sizeof(*b->el));
+  if (fmt == EL_TEXT) {
+    b->text = aligned_malloc(NE_chunk_size * TEXT_LINE_MAX);
+    b->ntext = omp_get_max_threads();
+    b->text_len = malloc(b->ntext * sizeof(*b->text_len));
+  }
+  if (!(b->el || b->el_32) || (fmt == EL_TEXT && (!b->text || !b->text_len)))
+    DIE_PERROR("Cannot malloc chunk buffers: ");
+}
+
+static void free_chunk_buffers(struct chunk_buffers *b) {
+  free(b->text_len);
+  free(b->text);
+  free(b->el_32);
+  free(b->el);
+}
+
+// Generate edges [begin, begin + ngen) into b, adding them to fp, and
+// return the bytes to write, in *out.  The binary formats are generated
+// in their file layout and written straight from the generator's buffer.
+static size_t encode_chunk(struct chunk_buffers *b, enum el_format fmt,
+                           int64_t begin, int64_t ngen, const char **out,
+                           struct edge_fingerprint *fp) {
+  switch (fmt) {
+    case EL_32:
+      edge_list_aos_32(b->el_32, begin, ngen, fp);
+      *out = (const char *)b->el_32;
+      return ngen * el_edge_bytes(fmt);
+    case EL_64:
+      edge_list_pairs_64(b->el, begin, ngen, fp);
+      *out = (const char *)b->el;
+      return ngen * el_edge_bytes(fmt);
+    case EL_W64:
+      edge_list_aos_64(b->el, begin, ngen, fp);
+      *out = (const char *)b->el;
+      return ngen * el_edge_bytes(fmt);
+    default:
+      break;
+  }
+  edge_list_aos_64(b->el, begin, ngen, fp);
+  *out = b->text;
+  return format_text(b->text, b->text_len, b->ntext, b->el, ngen);
+}
+
+/* Checksum of the binary records of edges [begin, begin + n): the sum
+   of a hash of each edge's index and bytes.  Sums over adjacent ranges
+   add up to the sum over their union, and moving an edge changes it. */
+static uint64_t edge_checksum(const char *rec, size_t edge_bytes,
+                              int64_t begin, int64_t n) {
+  uint64_t sum = 0;
+  OMP(parallel for reduction(+ : sum))
+  for (int64_t k = 0; k < n; ++k) {
+    uint64_t h = mix64(begin + k);
+    for (size_t w = 0; w < edge_bytes; w += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, rec + k * edge_bytes + w, sizeof(word));
+      h = mix64(h ^ word);
+    }
+    sum += h;
+  }
+  return sum;
+}
+
+/* Add edges [begin, begin + n), laid out as fmt in rec, to fp. */
+static void fingerprint_records(struct edge_fingerprint *fp, const void *rec,
+                                enum el_format fmt, int64_t begin, int64_t n) {
+  if (fmt == EL_32)
+    edge_fingerprint_32(fp, rec, begin, n);
+  else {
+    const int64_t *el = rec;
+    edge_fingerprint_64(fp, el, el + 1, fmt == EL_64 ? 2 : 3, begin, n);
+  }
+}
+
+struct shard {
+  int64_t begin, ne;
+  off_t offset; // of the edges in the shard's file
+  size_t bytes;
+  struct edge_fingerprint fp;
+};
+
+/* Write the list as nshards edge ranges, one per OpenMP iteration, each
+   generated chunk by chunk into that thread's own aligned buffers and
+   written with plain write(2)s.  Binary lists may go to disjoint ranges
+   of filename at computed offsets (one_file), giving the same file as
+   the single stream; otherwise shard s goes to filename.s, a complete
+   list of its own whose header adds --edge_begin and --shard.  Either
+   way filename.manifest lists the shards. */
+static void write_shards(const char *filename, int nshards, int one_file,
+                         int compress, enum el_format fmt,
+                         const uint64_t seeds[4], size_t NE_chunk_size) {
+  char hdr[640];
+  struct shard *sh = calloc(nshards, sizeof(*sh));
+  if (!sh) DIE_PERROR("Cannot malloc shards: ");
+  for (int s = 0; s < nshards; ++s) {
+    sh[s].begin = NE / nshards * s + (s < NE % nshards ? s : NE % nshards);
+    sh[s].ne = NE / nshards + (s < NE % nshards);
+  }
+  const size_t edge_bytes = el_edge_bytes(fmt);
+
+  int fd = -1;
+  struct edge_fingerprint fp = {0, 0};
+  if (one_file) {
+    // The header is rewritten with the fingerprint at the end.
+    fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) DIE_PERROR("Error opening \"%s\": ", filename);
+    const int len =
+        range_header(hdr, sizeof(hdr), fmt, seeds, 0, NE, -1, 0, &fp);
+    if (ftruncate(fd, len + NE * edge_bytes))
+      DIE_PERROR("Error sizing \"%s\": ", filename);
+    for (int s = 0; s < nshards; ++s)
+      sh[s].offset = len + sh[s].begin * edge_bytes;
+  }
+
+  OMP(parallel for schedule(dynamic, 1))
+  for (int s = 0; s < nshards; ++s) {
+    struct chunk_buffers b;
+    alloc_chunk_buffers(&b, fmt, NE_chunk_size);
+
+    int sfd = fd;
+    off_t pos = sh[s].offset;
+    struct sink out = {.fd = -1};
+    if (!one_file) {
+      char path[PATH_MAX], head[600];
+      snprintf(path, sizeof(path), "%s.%d", filename, s);
+      sfd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (sfd < 0) DIE_PERROR("Error opening \"%s\": ", path);
+      int len = 0;
+      if (fmt != EL_TEXT) {
+        len = format_header(head, sizeof(head), fmt, sh[s].ne, seeds);
+        len += sprintf(head + len, " --edge_begin %ld --shard %d/%d\n",
+                       (long)sh[s].begin, s, nshards);
+      } else if (args.neo4j_flag)
+        len = sprintf(head, ":TYPE,:START_ID,:END_ID\n");
+      sink_open(&out, sfd, compress);
+      sink_write(&out, head, len);
+      sh[s].offset = len;
+    }
+
+    for (int64_t done = 0; done < sh[s].ne; done += NE_chunk_size) {
+      const int64_t ngen = sh[s].ne - done < (int64_t)NE_chunk_size
+                               ? sh[s].ne - done
+                               : (int64_t)NE_chunk_size;
+      const char *buf;
+      const size_t len = encode_chunk(&b, fmt, sh[s].begin + done, ngen, &buf,
+                                      &sh[s].fp);
+      if (one_file) {
+        write_all(sfd, buf, len, pos);
+        pos += len;
+      } else
+        sink_write(&out, buf, len);
+      sh[s].bytes += len;
+    }
+    VERBOSELVL_PRINT(2, "  shard %d/%d: %ld edges\n", s + 1, nshards,
+                     (long)sh[s].ne);
+
+    if (!one_file) sink_close(&out);
+    free_chunk_buffers(&b);
+  }
+  for (int s = 0; s < nshards; ++s) {
+    fp.multiset += sh[s].fp.multiset;
+    fp.ordered += sh[s].fp.ordered;
+  }
+  if (one_file) {
+    const int len =
+        range_header(hdr, sizeof(hdr), fmt, seeds, 0, NE, -1, 0, &fp);
+    write_all(fd, hdr, len, 0);
+    if (close(fd)) DIE_PERROR("Error closing \"%s\": ", filename);
+  }
+
+  char path[PATH_MAX];
+  snprintf(path, sizeof(path), "%s.manifest", filename);
+  FILE *m = fopen(path, "w");
+  if (!m) DIE_PERROR("Error opening \"%s\": ", path);
+  if (fmt != EL_TEXT)
+    format_header(hdr, sizeof(hdr), fmt, NE, seeds);
+  else
+    snprintf(hdr, sizeof(hdr), "--format %s --num_edges %ld --num_vertices %ld",
+             args.neo4j_flag ? "neo4j" : "text", (long)NE, (long)NV);
+  fprintf(m,
+          "# %s --nshards %d --fingerprint " EDGE_FINGERPRINT_FMT
+          "\n# shard file edge_begin num_edges offset bytes\n",
+          hdr, nshards, fp.multiset, fp.ordered);
+  for (int s = 0; s < nshards; ++s) {
+    if (one_file)
+      fprintf(m, "%d %s", s, filename);
+    else
+      fprintf(m, "%d %s.%d", s, filename, s);
+    fprintf(m, " %ld %ld %ld %zu\n", (long)sh[s].begin, (long)sh[s].ne,
+            (long)sh[s].offset, sh[s].bytes);
+  }
+  if (fclose(m)) DIE_PERROR("Error writing \"%s\": ", path);
+  fprintf(stderr, "Fingerprint: " EDGE_FINGERPRINT_FMT "\n", fp.multiset,
+          fp.ordered);
+  free(sh);
+}
+
+/* The single stream with generation and writing overlapped: chunk k
+   is written from one output buffer while chunk k + 1 is generated and
+   encoded into the other.  head goes out first.  With direct, fd is
+   O_DIRECT, so only whole OUT_ALIGN blocks are written from a buffer
+   and the rest is carried to the front of the other; the last partial
+   block goes out after O_DIRECT is cleared.  Reports how much of the
+   shorter phase was hidden behind the longer.  Writes edges
+   [e_begin, e_end), adding them to *fp and their checksum to *sum if
+   sum is set. */
+static void write_pipelined(struct sink *sink, int direct, enum el_format fmt,
+                            const char *head, size_t head_len, int64_t e_begin,
+                            int64_t e_end, size_t NE_chunk_size,
+                            struct edge_fingerprint *fp, uint64_t *sum) {
+  const int64_t ne = e_end - e_begin;
+  const size_t nchunks = (ne + NE_chunk_size - 1) / NE_chunk_size;
+  const size_t cap =
+      OUT_ALIGN + NE_chunk_size * (fmt != EL_TEXT ? el_edge_bytes(fmt)
+                                                  : TEXT_LINE_MAX);
+  char *out[2] = {aligned_malloc(cap), aligned_malloc(cap)};
+  if (!out[0] || !out[1]) DIE_PERROR("Cannot malloc pipeline buffers: ");
+  struct chunk_buffers b;
+  alloc_chunk_buffers(&b, fmt, NE_chunk_size);
+  assert(head_len < OUT_ALIGN);
+  memcpy(out[0], head, head_len);
+
+#if defined(_OPENMP)
+  // The generator's own parallel loops run inside a section.
+  omp_set_max_active_levels(2);
+#endif
+  size_t fill = head_len, wlen = 0;
+  double gen_ms = 0.0, write_ms = 0.0;
+  const double begin = wall_ms();
+  for (size_t ck = 0; ck <= nchunks; ++ck) {
+    const int cur = ck & 1;
+    OMP(parallel sections num_threads(2)) {
+      OMP(section)
+      if (wlen) {
+        const double t0 = wall_ms();
+        sink_write(sink, out[!cur], wlen);
+        write_ms += wall_ms() - t0;
+      }
+      OMP(section)
+      if (ck < nchunks) {
+        const double t0 = wall_ms();
+        const int64_t first = e_begin + ck * NE_chunk_size;
+        const int64_t ngen = e_end - first < (int64_t)NE_chunk_size
+                                 ? e_end - first
+                                 : (int64_t)NE_chunk_size;
+        const char *src;
+        const size_t len = encode_chunk(&b, fmt, first, ngen, &src, fp);
+        if (sum) *sum += edge_checksum(src, el_edge_bytes(fmt), first, ngen);
+        memcpy(out[cur] + fill, src, len);
+        fill += len;
+        gen_ms += wall_ms() - t0;
+        VERBOSELVL_PRINT(2, "  chunk %ld/%ld  %ld %ld\n", (long)ck + 1,
+                         (long)nchunks, (long)ne, (long)ngen);
+      }
+    }
+    wlen = direct ? fill & ~(size_t)(OUT_ALIGN - 1) : fill;
+    // out[!cur] is free again; the next chunk goes in after the carry.
+    memcpy(out[!cur], out[cur] + wlen, fill - wlen);
+    fill -= wlen;
+  }
+  if (wlen) sink_write(sink, out[nchunks & 1], wlen);
+  if (fill) {
+#if defined(O_DIRECT)
+    if (direct &&
+        fcntl(sink->fd, F_SETFL, fcntl(sink->fd, F_GETFL) & ~O_DIRECT))
+      DIE_PERROR("Cannot clear O_DIRECT: ");
+#endif
+    sink_write(sink, out[nchunks & 1 ? 0 : 1], fill);
+  }
+  const double total = wall_ms() - begin;
+
+  const double shorter = gen_ms < write_ms ? gen_ms : write_ms;
+  double overlap = shorter > 0 ? (gen_ms + write_ms - total) / shorter : 0.0;
+  if (overlap < 0) overlap = 0.0;
+  if (overlap > 1) overlap = 1.0;
+  fprintf(stderr,
+          "Pipeline: generate %g ms, write %g ms, wall %g ms, overlap "
+          "efficiency %g\n",
+          gen_ms, write_ms, total, overlap);
+
+  free_chunk_buffers(&b);
+  free(out[1]);
+  free(out[0]);
+}
+
+// Pairs staged per bucket before a spill write.
+#define SPILL_PAIRS 8192
+// Headroom for uneven buckets: R-MAT's hubs land in few of them.
+#define BUCKET_SLACK 2
+
+// Write n sorted pairs in fmt, narrowing through narrow (of narrow_n
+// pairs) for el32.
+static void emit_pairs(struct sink *out, enum el_format fmt,
+                       const uint64_t *pairs, uint64_t n, uint32_t *narrow,
+                       uint64_t narrow_n) {
+  if (fmt == EL_64) {
+    sink_write(out, (const char *)pairs, n * el_edge_bytes(fmt));
+    return;
+  }
+  for (uint64_t k0 = 0; k0 < n; k0 += narrow_n) {
+    const uint64_t m = n - k0 < narrow_n ? n - k0 : narrow_n;
+    parfor(uint64_t k = 0; k < 2 * m; ++k) narrow[k] = pairs[2 * k0 + k];
+    sink_write(out, (const char *)narrow, m * el_edge_bytes(fmt));
+  }
+}
+
+static void write_sorted_header(struct sink *out, enum el_format fmt,
+                                uint64_t ne, const uint64_t seeds[4],
+                                const struct edge_fingerprint *fp) {
+  char head[640];
+  int len = format_header(head, sizeof(head), fmt, ne, seeds);
+  len += sprintf(head + len,
+                 " --is_sorted --is_deduped --fingerprint " EDGE_FINGERPRINT_FMT
+                 "\n",
+                 fp->multiset, fp->ordered);
+  sink_write(out, head, len);
+}
+
+/* The list symmetrized, sorted by (i, j), deduplicated, and without
+   self-loops, as el32 or el64.  When all the pairs and the sort's
+   scratch fit in mem bytes they are sorted in memory.  Otherwise the
+   first pass spills each chunk's pairs to temporary files in tmpdir by
+   range of i, then each bucket is sorted, deduplicated, and written
+   back in turn.  The header's count is known only then, so the buckets
+   are copied out after it. */
+static void write_sorted(struct sink *out, enum el_format fmt,
+                         const uint64_t seeds[4], size_t NE_chunk_size,
+                         uint64_t mem, const char *tmpdir,
+                         struct edge_fingerprint *fp) {
+  const uint64_t npairs = 2 * (uint64_t)NE;
+  const uint64_t pair_bytes = 2 * 2 * sizeof(uint64_t); // with scratch
+  uint32_t *narrow = NULL;
+  if (fmt == EL_32 && !(narrow = malloc(2 * NE_chunk_size * sizeof(*narrow))))
+    DIE_PERROR("Cannot malloc output buffer: ");
+
+  if (npairs * pair_bytes <= mem) {
+    uint64_t *pairs = malloc((npairs ? npairs : 1) * 2 * sizeof(*pairs));
+    uint64_t *tmp = malloc((npairs ? npairs : 1) * 2 * sizeof(*tmp));
+    if (!pairs || !tmp) DIE_PERROR("Cannot malloc edge pairs: ");
+    uint64_t n = 0;
+    for (int64_t first = 0; first < NE; first += NE_chunk_size) {
+      const int64_t ngen = NE - first < (int64_t)NE_chunk_size
+                               ? NE - first
+                               : (int64_t)NE_chunk_size;
+      edge_list_pairs_64((int64_t *)pairs + 2 * n, first, ngen, fp);
+      n += elsort_symmetrize(pairs + 2 * n, ngen);
+    }
+    if (elsort_pairs(pairs, tmp, n, SCALE)) DIE_PERROR("Cannot sort: ");
+    n = elsort_unique(pairs, n);
+    VERBOSE_PRINT("%lu distinct pairs... ", (unsigned long)n);
+    write_sorted_header(out, fmt, n, seeds, fp);
+    emit_pairs(out, fmt, pairs, n, narrow, NE_chunk_size);
+    free(tmp);
+    free(pairs);
+    free(narrow);
+    return;
+  }
+
+  const uint64_t nbucket =
+      (BUCKET_SLACK * npairs * pair_bytes + mem - 1) / mem;
+  const uint64_t range = (NV + nbucket - 1) / nbucket;
+  VERBOSE_PRINT("spilling to %lu buckets in %s... ", (unsigned long)nbucket,
+                tmpdir);
+  int *fd = malloc(nbucket * sizeof(*fd));
+  uint64_t *count = calloc(nbucket, sizeof(*count));
+  uint64_t *fill = calloc(nbucket, sizeof(*fill));
+  uint64_t *stage = malloc(nbucket * SPILL_PAIRS * 2 * sizeof(*stage));
+  uint64_t *chunk = malloc(2 * NE_chunk_size * 2 * sizeof(*chunk));
+  if (!fd || !count || !fill || !stage || !chunk)
+    DIE_PERROR("Cannot malloc buckets: ");
+  for (uint64_t b = 0; b < nbucket; ++b) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/el-sort-XXXXXX", tmpdir);
+    fd[b] = mkstemp(path);
+    if (fd[b] < 0) DIE_PERROR("Cannot create \"%s\": ", path);
+    unlink(path); // gone when closed
+  }
+
+  for (int64_t first = 0; first < NE; first += NE_chunk_size) {
+    const int64_t ngen = NE - first < (int64_t)NE_chunk_size
+                             ? NE - first
+                             : (int64_t)NE_chunk_size;
+    edge_list_pairs_64((int64_t *)chunk, first, ngen, fp);
+    const uint64_t n = elsort_symmetrize(chunk, ngen);
+    for (uint64_t k = 0; k < n; ++k) {
+      const uint64_t b = chunk[2 * k] / range;
+      uint64_t *st = stage + b * SPILL_PAIRS * 2;
+      st[2 * fill[b]] = chunk[2 * k];
+      st[2 * fill[b] + 1] = chunk[2 * k + 1];
+      if (++fill[b] == SPILL_PAIRS) {
+        write_all(fd[b], (const char *)st, sizeof(*st) * 2 * SPILL_PAIRS, -1);
+        count[b] += SPILL_PAIRS;
+        fill[b] = 0;
+      }
+    }
+  }
+  uint64_t max_count = 0;
+  for (uint64_t b = 0; b < nbucket; ++b) {
+    write_all(fd[b], (const char *)(stage + b * SPILL_PAIRS * 2),
+              sizeof(*stage) * 2 * fill[b], -1);
+    count[b] += fill[b];
+    if (count[b] > max_count) max_count = count[b];
+  }
+  free(chunk);
+  free(stage);
+
+  uint64_t *pairs = malloc((max_count ? max_count : 1) * 2 * sizeof(*pairs));
+  uint64_t *tmp = malloc((max_count ? max_count : 1) * 2 * sizeof(*tmp));
+  if (!pairs || !tmp) DIE_PERROR("Cannot malloc a bucket: ");
+  uint64_t total = 0;
+  for (uint64_t b = 0; b < nbucket; ++b) {
+    const size_t bytes = count[b] * 2 * sizeof(*pairs);
+    if (pread(fd[b], pairs, bytes, 0) != (ssize_t)bytes)
+      DIE_PERROR("Error reading bucket %lu: ", (unsigned long)b);
+    if (elsort_pairs(pairs, tmp, count[b], SCALE)) DIE_PERROR("Cannot sort: ");
+    count[b] = elsort_unique(pairs, count[b]);
+    if (ftruncate(fd[b], 0))
+      DIE_PERROR("Error truncating bucket %lu: ", (unsigned long)b);
+    write_all(fd[b], (const char *)pairs, count[b] * 2 * sizeof(*pairs), 0);
+    total += count[b];
+  }
+  VERBOSE_PRINT("%lu distinct pairs... ", (unsigned long)total);
+
+  write_sorted_header(out, fmt, total, seeds, fp);
+  for (uint64_t b = 0; b < nbucket; ++b) {
+    const size_t bytes = count[b] * 2 * sizeof(*pairs);
+    if (pread(fd[b], pairs, bytes, 0) != (ssize_t)bytes)
+      DIE_PERROR("Error reading bucket %lu: ", (unsigned long)b);
+    emit_pairs(out, fmt, pairs, count[b], narrow, NE_chunk_size);
+    close(fd[b]);
+  }
+  free(tmp);
+  free(pairs);
+  free(fill);
+  free(count);
+  free(fd);
+  free(narrow);
+}
+
+/* "begin:end" as edge indices in [0, NE]; an empty end is NE. */
+static void parse_edge_range(const char *str, int64_t *begin, int64_t *end) {
+  char *p;
+  errno = 0;
+  *begin = strtoll(str, &p, 10);
+  if (errno || p == str || *p != ':')
+    DIE("--edge-range must be begin:end, not \"%s\"\n", str);
+  const char *q = p + 1;
+  *end = NE;
+  if (*q) {
+    *end = strtoll(q, &p, 10);
+    if (errno || *p) DIE("--edge-range must be begin:end, not \"%s\"\n", str);
+  }
+  if (*begin < 0 || *begin > *end || *end > NE)
+    DIE("--edge-range %s is not within the %ld edges\n", str, (long)NE);
+}
+
+/* For --resume: fd holds what an earlier run with the same options
+   wrote.  Its header must be head, but for a fingerprint at fp_off (if
+   not negative); a header cut short is rewritten.  The whole edges
+   after it are kept and a partial last edge dropped.  Leaves fd at the
+   end and returns the number of edges kept. */
+static int64_t resume_list(int fd, const char *path, const char *head,
+                           size_t head_len, int fp_off, size_t edge_bytes,
+                           int64_t ne) {
+  const off_t size = lseek(fd, 0, SEEK_END);
+  if (size < 0) DIE_PERROR("Cannot seek \"%s\": ", path);
+  char old[640];
+  const size_t n = (size_t)size < head_len ? (size_t)size : head_len;
+  if (pread(fd, old, n, 0) != (ssize_t)n)
+    DIE_PERROR("Error reading \"%s\": ", path);
+  if (fp_off >= 0 && n > (size_t)fp_off)
+    memcpy(old + fp_off, head + fp_off,
+           n - fp_off < EDGE_FINGERPRINT_LEN ? n - fp_off
+                                             : EDGE_FINGERPRINT_LEN);
+  if (memcmp(old, head, n))
+    DIE("\"%s\" was not written with these options; not resuming\n", path);
+  int64_t done = 0;
+  if ((size_t)size < head_len)
+    write_all(fd, head, head_len, 0);
+  else {
+    done = (size - head_len) / edge_bytes;
+    if (done > ne)
+      DIE("\"%s\" holds more than %ld edges\n", path, (long)ne);
+  }
+  if (ftruncate(fd, head_len + done * edge_bytes))
+    DIE_PERROR("Error truncating \"%s\": ", path);
+  if (lseek(fd, 0, SEEK_END) < 0)
+    DIE_PERROR("Cannot seek \"%s\": ", path);
+  return done;
+}
+
+// Rank r's edges: a contiguous run of whole chunks.
+static void rank_range(int rank, int nranks, size_t NE_chunk_size,
+                       int64_t *begin, int64_t *end) {
+  const int64_t nchunks = (NE + NE_chunk_size - 1) / NE_chunk_size;
+  *begin = nchunks * rank / nranks * NE_chunk_size;
+  *end = nchunks * (rank + 1) / nranks * NE_chunk_size;
+  if (*begin > NE) *begin = NE;
+  if (*end > NE) *end = NE;
+}
+
+/* Checksum n edges starting with edge begin at offset off of in, and
+   add them to fp, copying them to offset out_off of out unless out < 0. */
+static uint64_t copy_checksum(int in, const char *path, off_t off, int out,
+                              off_t out_off, enum el_format fmt, int64_t begin,
+                              int64_t n, struct edge_fingerprint *fp) {
+  const size_t edge_bytes = el_edge_bytes(fmt);
+  const int64_t block = (8 << 20) / edge_bytes;
+  char *buf = aligned_malloc(block * edge_bytes);
+  if (!buf) DIE_PERROR("Cannot malloc copy buffer: ");
+  uint64_t sum = 0;
+  for (int64_t done = 0; done < n; done += block) {
+    const int64_t m = n - done < block ? n - done : block;
+    const size_t len = m * edge_bytes;
+    if (pread(in, buf, len, off + done * edge_bytes) != (ssize_t)len)
+      DIE_PERROR("Error reading \"%s\": ", path);
+    sum += edge_checksum(buf, edge_bytes, begin + done, m);
+    fingerprint_records(fp, buf, fmt, begin + done, m);
+    if (out >= 0) write_all(out, buf, len, out_off + done * edge_bytes);
+  }
+  free(buf);
+  return sum;
+}
+
+// path.sum: the header, then "edge_begin num_edges checksum".
+static void write_sum(const char *path, const char *head, int64_t begin,
+                      int64_t ne, uint64_t sum) {
+  char sum_path[PATH_MAX + 8];
+  snprintf(sum_path, sizeof(sum_path), "%s.sum", path);
+  FILE *f = fopen(sum_path, "w");
+  if (!f) DIE_PERROR("Error opening \"%s\": ", sum_path);
+  fprintf(f, "# %.*s\n%ld %ld %016lx\n", (int)strcspn(head, "\n"), head,
+          (long)begin, (long)ne, (unsigned long)sum);
+  if (fclose(f)) DIE_PERROR("Error writing \"%s\": ", sum_path);
+}
+
+static uint64_t read_sum(const char *path, int64_t begin, int64_t ne) {
+  char sum_path[PATH_MAX + 8], line[640];
+  snprintf(sum_path, sizeof(sum_path), "%s.sum", path);
+  FILE *f = fopen(sum_path, "r");
+  if (!f) DIE_PERROR("Error opening \"%s\": ", sum_path);
+  long b, n;
+  unsigned long sum;
+  if (!fgets(line, sizeof(line), f) ||
+      3 != fscanf(f, "%ld %ld %lx", &b, &n, &sum) || b != begin || n != ne)
+    DIE("\"%s\" does not describe edges %ld to %ld\n", sum_path, (long)begin,
+        (long)(begin + ne));
+  fclose(f);
+  return sum;
+}
+
+/* Run ranks 0 to nranks - 1 as child processes sharing the cores, and
+   wait for them.  Returns the rank in a child and -1 in the parent
+   once every rank has succeeded.  Called before any OpenMP region, so
+   the children start with a fresh thread pool. */
+static int launch_ranks(int nranks) {
+  int threads = omp_get_max_threads() / nranks;
+  if (threads < 1) threads = 1;
+  for (int r = 0; r < nranks; ++r) {
+    const pid_t pid = fork();
+    if (pid < 0) DIE_PERROR("Cannot start rank %d: ", r);
+    if (pid == 0) {
+      omp_set_num_threads(threads);
+      return r;
+    }
+  }
+  int failed = 0;
+  for (int r = 0; r < nranks; ++r) {
+    int status;
+    if (wait(&status) < 0) DIE_PERROR("Error waiting for the ranks: ");
+    if (!WIFEXITED(status) || WEXITSTATUS(status)) failed = 1;
+  }
+  if (failed) DIE("A rank failed; not merging\n");
+  return -1;
+}
+
+/* Concatenate the ranks' files behind one header for the whole list,
+   giving the file a single process writes.  Each rank's header must be
+   the one it was to write, and its edges must match its checksum; the
+   total goes to filename.sum.  The whole list's fingerprint is the sum
+   of the ranks'. */
+static void merge_ranks(const char *filename, int nranks, enum el_format fmt,
+                        const uint64_t seeds[4], size_t NE_chunk_size) {
+  const size_t edge_bytes = el_edge_bytes(fmt);
+  char head[640];
+  struct edge_fingerprint fp = {0, 0};
+  int len = range_header(head, sizeof(head), fmt, seeds, 0, NE, -1, 0, &fp);
+  const int out = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (out < 0) DIE_PERROR("Error opening \"%s\": ", filename);
+  if (ftruncate(out, len + NE * edge_bytes))
+    DIE_PERROR("Error sizing \"%s\": ", filename);
+
+  struct edge_fingerprint *rank_fp = calloc(nranks, sizeof(*rank_fp));
+  if (!rank_fp) DIE_PERROR("Cannot malloc fingerprints: ");
+  uint64_t total = 0;
+  OMP(parallel for schedule(dynamic, 1) reduction(+ : total))
+  for (int r = 0; r < nranks; ++r) {
+    char path[PATH_MAX], rhead[640], got[640];
+    int64_t begin, end;
+    rank_range(r, nranks, NE_chunk_size, &begin, &end);
+    const int rlen = range_header(rhead, sizeof(rhead), fmt, seeds, begin, end,
+                                  r, nranks, &rank_fp[r]);
+    const int fp_off = rlen - 1 - EDGE_FINGERPRINT_LEN;
+    snprintf(path, sizeof(path), "%s.%d", filename, r);
+    const int in = open(path, O_RDONLY);
+    if (in < 0) DIE_PERROR("Error opening \"%s\": ", path);
+    struct stat st;
+    if (fstat(in, &st)) DIE_PERROR("Cannot stat \"%s\": ", path);
+    if (pread(in, got, rlen, 0) != rlen ||
+        memcmp(got, rhead, fp_off) || got[rlen - 1] != '\n' ||
+        st.st_size != rlen + (end - begin) * (off_t)edge_bytes)
+      DIE("\"%s\" is not rank %d's complete list\n", path, r);
+    const uint64_t sum =
+        copy_checksum(in, path, rlen, out, len + begin * edge_bytes, fmt,
+                      begin, end - begin, &rank_fp[r]);
+    if (sum != read_sum(path, begin, end - begin))
+      DIE("\"%s\" does not match its checksum\n", path);
+    close(in);
+    VERBOSELVL_PRINT(2, "  rank %d/%d: %ld edges\n", r + 1, nranks,
+                     (long)(end - begin));
+    total += sum;
+  }
+  for (int r = 0; r < nranks; ++r) {
+    fp.multiset += rank_fp[r].multiset;
+    fp.ordered += rank_fp[r].ordered;
+  }
+  free(rank_fp);
+  len = range_header(head, sizeof(head), fmt, seeds, 0, NE, -1, 0, &fp);
+  write_all(out, head, len, 0);
+  if (close(out)) DIE_PERROR("Error closing \"%s\": ", filename);
+  write_sum(filename, head, 0, NE, total);
+  fprintf(stderr,
+          "Merged %d ranks into \"%s\", checksum %016lx, fingerprint "
+          EDGE_FINGERPRINT_FMT "\n",
+          nranks, filename, (unsigned long)total, fp.multiset, fp.ordered);
+}
+
 // static const char filetag[] = " --format el64 --num_edges 10658
 // --num_vertices 1024 --is_undirected --is_deduped"; static const char
 // reverse_filetag[] = "segdeneg";
@@ -32,11 +904,93 @@ int main(int argc, char **argv) {
   }
   if (args.verbose_given) verbose = args.verbose_arg;
 
-  FILE *f = stdout;
-  if (args.filename_given && strcmp(args.filename_arg, "-")) {
-    f = fopen(args.filename_arg, "w");
+  if (args.shards_arg < 0) DIE("--shards must be nonnegative\n");
+  const int nshards = args.shards_arg;
+  if (nshards && (!args.filename_given || !strcmp(args.filename_arg, "-")))
+    DIE("--shards needs a --filename\n");
+  if (args.shard_file_flag && (!nshards || !args.binary_flag))
+    DIE("--shard-file needs --shards and --binary\n");
+  if (args.pipeline_flag && nshards)
+    DIE("--pipeline writes the single stream, not --shards\n");
+  if (args.direct_flag && (!args.pipeline_flag || !args.filename_given ||
+                           !strcmp(args.filename_arg, "-")))
+    DIE("--direct needs --pipeline and a --filename\n");
+#if !defined(O_DIRECT)
+  if (args.direct_flag) DIE("This system has no O_DIRECT\n");
+#endif
+
+  int compress = 0;
+  if (!strcmp(args.compress_arg, "gzip"))
+    compress = 1;
+  else if (strcmp(args.compress_arg, "none"))
+    DIE("Unknown compression \"%s\" (none, gzip)\n", args.compress_arg);
+  if (args.sorted_flag &&
+      (!args.binary_flag || args.weights_flag || nshards || args.pipeline_flag))
+    DIE("--sorted needs --binary el32 or el64, and no --shards or --pipeline\n");
+  if (args.sort_memory_arg < 0) DIE("--sort-memory must be nonnegative\n");
+  if (compress && (args.direct_flag || args.shard_file_flag))
+    DIE("--compress does not apply to --direct or --shard-file\n");
+  if (args.edge_range_given && (nshards || args.sorted_flag))
+    DIE("--edge-range does not apply to --shards or --sorted\n");
+  if (args.resume_flag &&
+      (!args.binary_flag || !args.filename_given ||
+       !strcmp(args.filename_arg, "-") || nshards || args.sorted_flag ||
+       compress || args.direct_flag))
+    DIE("--resume needs --binary and a --filename, and no --shards, "
+        "--sorted, --compress or --direct\n");
+
+  const int nranks = args.nranks_arg;
+  int rank = -1;
+  if (nranks < 0) DIE("--nranks must be nonnegative\n");
+  if (nranks) {
+    if (!args.binary_flag || !args.filename_given ||
+        !strcmp(args.filename_arg, "-") || nshards || args.sorted_flag ||
+        args.edge_range_given || compress)
+      DIE("--nranks needs --binary and a --filename, and no --shards, "
+          "--sorted, --edge-range or --compress\n");
+    if (args.rank_given)
+      rank = args.rank_arg;
+    else if (!args.launch_flag && !args.merge_flag) {
+      // As started by mpirun or srun.
+      const char *env = getenv("OMPI_COMM_WORLD_RANK");
+      if (!env) env = getenv("PMI_RANK");
+      if (!env) DIE("--nranks needs --rank, --launch or --merge\n");
+      rank = atoi(env);
+    }
+    if ((rank >= 0) + args.launch_flag + args.merge_flag != 1)
+      DIE("Give only one of --rank, --launch and --merge\n");
+    if (args.rank_given && (rank < 0 || rank >= nranks))
+      DIE("--rank must be in 0 to %d\n", nranks - 1);
+    if (args.launch_flag) rank = launch_ranks(nranks);
+  } else if (args.rank_given || args.launch_flag || args.merge_flag)
+    DIE("--rank, --launch and --merge need --nranks\n");
+  const int checksum = args.checksum_flag || rank >= 0;
+  if (args.checksum_flag &&
+      (!args.binary_flag || !args.filename_given ||
+       !strcmp(args.filename_arg, "-") || nshards || args.sorted_flag))
+    DIE("--checksum needs --binary and a --filename, and no --shards or "
+        "--sorted\n");
+
+  // The single stream, unless sharding or merging.
+  int fd = -1;
+  char path[PATH_MAX];
+  if (rank >= 0)
+    snprintf(path, sizeof(path), "%s.%d", args.filename_arg, rank);
+  else if (args.filename_given)
+    snprintf(path, sizeof(path), "%s", args.filename_arg);
+  if (!nshards && !(nranks && rank < 0)) {
+    fd = STDOUT_FILENO;
+    if (args.filename_given && strcmp(args.filename_arg, "-")) {
+      // Resuming keeps what is there, and reads its header.
+      int flags = args.resume_flag ? O_RDWR | O_CREAT
+                                   : O_WRONLY | O_CREAT | O_TRUNC;
+#if defined(O_DIRECT)
+      if (args.direct_flag) flags |= O_DIRECT;
+#endif
+      fd = open(path, flags, 0666);
+      if (fd < 0) DIE_PERROR("Error opening \"%s\": ", path);
+    }
   }
-  if (!f) DIE_PERROR("Error opening \"%s\": ", args.filename_arg);
 
   VERBOSE_PRINT("Starting el-generator\n");
 
@@ -48,55 +1002,124 @@ int main(int argc, char **argv) {
                1,  // unused
                args.A_arg, args.B_arg, args.noisefact_arg, args.tree_flag);
 
+  if (args.index_bits_arg != 32 && args.index_bits_arg != 64)
+    DIE("--index-bits must be 32 or 64\n");
+  if (args.weights_flag && (!args.binary_flag || args.index_bits_arg != 64))
+    DIE("--weights needs --binary with 64-bit ids\n");
+  // el32 halves the file and the write bandwidth.
+  enum el_format fmt = EL_TEXT;
+  if (args.binary_flag)
+    fmt = args.weights_flag ? EL_W64 : args.index_bits_arg == 32 ? EL_32 : EL_64;
+  if (fmt == EL_32 && NV > (int64_t)UINT32_MAX + 1)
+    DIE("Scale %d is too large for 32-bit vertex ids\n", args.scale_arg);
+
   VERBOSE_PRINT("Creating edge list... ");
 
-  if (args.binary_flag) {
+  const size_t NE_chunk_size = args.NE_chunk_size_arg;
+  if (nranks && rank < 0) {
+    merge_ranks(args.filename_arg, nranks, fmt, seeds, NE_chunk_size);
+    VERBOSE_PRINT("DONE\n");
+    return 0;
+  }
+  if (nshards) {
+    write_shards(args.filename_arg, nshards, args.shard_file_flag, compress,
+                 fmt, seeds, NE_chunk_size);
+    VERBOSE_PRINT("DONE\n");
+    return 0;
+  }
+
+  int64_t e_begin = 0, e_end = NE;
+  if (rank >= 0)
+    rank_range(rank, nranks, NE_chunk_size, &e_begin, &e_end);
+  else if (args.edge_range_given)
+    parse_edge_range(args.edge_range_arg, &e_begin, &e_end);
+  const int64_t range_begin = e_begin;
+
+  // A binary list in a file we opened gets its fingerprint in the
+  // header once the edges are out.  Not stdout, even redirected to a
+  // file: the header need not start at offset 0 there.
+  struct edge_fingerprint fp = {0, 0};
+  struct stat st;
+  const int fp_in_header = args.binary_flag && !args.sorted_flag &&
+                           !compress && fd != STDOUT_FILENO &&
+                           !fstat(fd, &st) && S_ISREG(st.st_mode);
+
+  char head[640];
+  int len = 0, fp_off = -1;
+  if (args.sorted_flag)
+    ;  // written once the count is known
+  else if (args.binary_flag) {
     // fwrite(filetag, 1, 8, f);
-    fprintf(f,
-            "--format el64 --num_edges %ld --num_vertices %ld --is_undirected "
-            "--seed0 %lu --seed1 %lu --seed2 %lu --seed3 %lu\n",
-            NE, NV, seeds[0], seeds[1], seeds[2], seeds[3]);
+    len = range_header(head, sizeof(head), fmt, seeds, e_begin, e_end, rank,
+                       nranks, fp_in_header ? &fp : NULL);
+    if (fp_in_header) fp_off = len - 1 - EDGE_FINGERPRINT_LEN;
+  } else if (args.neo4j_flag && e_begin == 0)
+    len = sprintf(head, ":TYPE,:START_ID,:END_ID\n");
 
-  } else if (args.neo4j_flag)
-    fprintf(f, ":TYPE,:START_ID,:END_ID\n");
+  uint64_t sum = 0;
+  int head_len = len;
+  if (args.resume_flag) {
+    const int64_t done = resume_list(fd, path, head, len, fp_off,
+                                     el_edge_bytes(fmt), e_end - e_begin);
+    VERBOSE_PRINT("resuming after %ld of %ld edges... ", (long)done,
+                  (long)(e_end - e_begin));
+    sum = copy_checksum(fd, path, len, -1, 0, fmt, e_begin, done, &fp);
+    e_begin += done;
+    head_len = 0;  // already there
+  }
 
-  const size_t NE_chunk_size = args.NE_chunk_size_arg;
-  const size_t nchunks = (NE + NE_chunk_size - 1) / NE_chunk_size;
-
-  int64_t *el = NULL;
-  el = malloc(3 * NE_chunk_size * sizeof(int64_t));
-  assert(el);
-
-  for (uint64_t ck = 0; ck < nchunks; ++ck) {
-    uint64_t ngen = NE_chunk_size;
-    if (ck * NE_chunk_size + ngen > NE) ngen = NE - ck * NE_chunk_size;
-    VERBOSELVL_PRINT(2, "  chunk %ld/%ld  %ld %ld\n", (long)ck + 1,
-                     (long)nchunks, (long)NE, (long)ngen);
-    edge_list_aos_64(el, ck * NE_chunk_size, ngen);
-
-    if (args.binary_flag) {
-      // fwrite(el, sizeof(*el), 3 * ngen, f);
-      // This is a hack, Jason's code was writing weights and we only need edges
-      // could be sped up if we created array of just weight (i,j) instead of
-      // (i,j,weight) triplets
-      for (size_t k = 0; k < ngen; ++k) {
-        fwrite(&el[k * 3], sizeof(uint64_t), 2, f);
-      }
+  fflush(stdout);  // anything already printed goes first
+  struct sink out;
+  sink_open(&out, fd, compress);
+  if (args.sorted_flag) {
+    // Half of physical memory unless told.
+    uint64_t mem = (uint64_t)args.sort_memory_arg << 20;
+    if (!mem) mem = (uint64_t)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE) / 2;
+    write_sorted(&out, fmt, seeds, NE_chunk_size, mem, args.sort_tmpdir_arg,
+                 &fp);
+  } else if (args.pipeline_flag)
+    write_pipelined(&out, args.direct_flag, fmt, head, head_len, e_begin,
+                    e_end, NE_chunk_size, &fp, checksum ? &sum : NULL);
+  else {
+    sink_write(&out, head, head_len);
 
-    } else {
-      if (args.neo4j_flag)
-        for (size_t k = 0; k < ngen; ++k)
-          fprintf(f, "EDGE,%" PRId64 ",%" PRId64 "\n", el[3 * k],
-                  el[1 + 3 * k]);
-      else
-        for (size_t k = 0; k < ngen; ++k)
-          fprintf(f, "%" PRId64 "\t%" PRId64 "\t%" PRId64 "\n", el[3 * k],
-                  el[1 + 3 * k], el[2 + 3 * k]);
+    const int64_t ne = e_end - e_begin;
+    const size_t nchunks = (ne + NE_chunk_size - 1) / NE_chunk_size;
+
+    struct chunk_buffers b;
+    alloc_chunk_buffers(&b, fmt, NE_chunk_size);
+
+    for (uint64_t ck = 0; ck < nchunks; ++ck) {
+      uint64_t ngen = NE_chunk_size;
+      if (ck * NE_chunk_size + ngen > (uint64_t)ne)
+        ngen = ne - ck * NE_chunk_size;
+      VERBOSELVL_PRINT(2, "  chunk %ld/%ld  %ld %ld\n", (long)ck + 1,
+                       (long)nchunks, (long)ne, (long)ngen);
+      const char *buf;
+      const size_t n =
+          encode_chunk(&b, fmt, e_begin + ck * NE_chunk_size, ngen, &buf, &fp);
+      if (checksum)
+        sum += edge_checksum(buf, el_edge_bytes(fmt),
+                             e_begin + ck * NE_chunk_size, ngen);
+      sink_write(&out, buf, n);
     }
+    free_chunk_buffers(&b);
   }
-
-  if (f) fclose(f);
-  free(el);
+  if (fp_off >= 0) {
+    char digits[EDGE_FINGERPRINT_LEN + 1];
+    snprintf(digits, sizeof(digits), EDGE_FINGERPRINT_FMT, fp.multiset,
+             fp.ordered);
+    memcpy(head + fp_off, digits, EDGE_FINGERPRINT_LEN);
+#if defined(O_DIRECT)
+    if (args.direct_flag && fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT))
+      DIE_PERROR("Cannot clear O_DIRECT: ");
+#endif
+    write_all(fd, digits, EDGE_FINGERPRINT_LEN, fp_off);
+  }
+  sink_close(&out);
+  if (checksum) write_sum(path, head, range_begin, e_end - range_begin, sum);
+  fprintf(stderr, "Fingerprint: " EDGE_FINGERPRINT_FMT "\n", fp.multiset,
+          fp.ordered);
 
   VERBOSE_PRINT("DONE\n");
 }
@@ -0,0 +1,726 @@
+/*
+  File autogenerated by gengetopt version 2.23
+  generated with the following command:
+  gengetopt -F el2csr-cmdline 
+
+  The developers of gengetopt consider the fixed text that goes in all
+  gengetopt output files to be in the public domain:
+  we make no copyright claims on it.
+*/
+
+/* If we use autoconf.  */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef FIX_UNUSED
+#define FIX_UNUSED(X) (void) (X) /* avoid warnings for unused params */
+#endif
+
+#include <getopt.h>
+
+#include "el2csr-cmdline.h"
+
+const char *gengetopt_args_info_purpose = "";
+
+const char *gengetopt_args_info_usage = "Usage: el2csr [OPTION]...";
+
+const char *gengetopt_args_info_versiontext = "Copyright 2022, Lucata Corporation";
+
+const char *gengetopt_args_info_description = "Converts an el-generator binary edge list into GrB-mxm-timer's binary CSR file, out of core.";
+
+const char *gengetopt_args_info_help[] = {
+  "  -h, --help              Print help and exit",
+  "  -V, --version           Print version and exit",
+  "  -i, --input=STRING      Edge list from el-generator --binary: el64, el32, or\n                            wel64",
+  "  -o, --output=STRING     Binary CSR file for GrB-mxm-timer --binary --filename",
+  "      --index-bits=INT    Column index width in the output: 64 or 32\n                            (default=`64')",
+  "  -m, --memory=LONG       MiB per bucket pass, which sets the number of buckets\n                            (0: half of physical memory)  (default=`0')",
+  "      --tmpdir=STRING     Directory for the spilled buckets  (default=`.')",
+  "",
+  "  -c, --b-ncols=INT       Number of columns in B  (default=`16')",
+  "  -C, --b-used-ncols=INT  Number of columns actually used in the initial B\n                            (default=`1')",
+  "  -E, --b-nents-col=INT   Number of entries per column in the initial B\n                            (default=`1')",
+  "",
+  "      --verbose[=INT]     Provide status updates via stdout.  (default=`1')",
+    0
+};
+
+typedef enum {ARG_NO
+  , ARG_FLAG
+  , ARG_STRING
+  , ARG_INT
+  , ARG_LONG
+  , ARG_FLOAT
+} cmdline_parser_arg_type;
+
+static
+void clear_given (struct gengetopt_args_info *args_info);
+static
+void clear_args (struct gengetopt_args_info *args_info);
+
+static int
+cmdline_parser_internal (int argc, char **argv, struct gengetopt_args_info *args_info,
+                        struct cmdline_parser_params *params, const char *additional_error);
+
+
+static char *
+gengetopt_strdup (const char *s);
+
+static
+void clear_given (struct gengetopt_args_info *args_info)
+{
+  args_info->help_given = 0 ;
+  args_info->version_given = 0 ;
+  args_info->input_given = 0 ;
+  args_info->output_given = 0 ;
+  args_info->index_bits_given = 0 ;
+  args_info->memory_given = 0 ;
+  args_info->tmpdir_given = 0 ;
+  args_info->b_ncols_given = 0 ;
+  args_info->b_used_ncols_given = 0 ;
+  args_info->b_nents_col_given = 0 ;
+  args_info->verbose_given = 0 ;
+}
+
+static
+void clear_args (struct gengetopt_args_info *args_info)
+{
+  FIX_UNUSED (args_info);
+  args_info->input_arg = NULL;
+  args_info->input_orig = NULL;
+  args_info->output_arg = NULL;
+  args_info->output_orig = NULL;
+  args_info->index_bits_arg = 64;
+  args_info->index_bits_orig = NULL;
+  args_info->memory_arg = 0;
+  args_info->memory_orig = NULL;
+  args_info->tmpdir_arg = gengetopt_strdup (".");
+  args_info->tmpdir_orig = NULL;
+  args_info->b_ncols_arg = 16;
+  args_info->b_ncols_orig = NULL;
+  args_info->b_used_ncols_arg = 1;
+  args_info->b_used_ncols_orig = NULL;
+  args_info->b_nents_col_arg = 1;
+  args_info->b_nents_col_orig = NULL;
+  args_info->verbose_arg = 1;
+  args_info->verbose_orig = NULL;
+  
+}
+
+static
+void init_args_info(struct gengetopt_args_info *args_info)
+{
+
+
+  args_info->help_help = gengetopt_args_info_help[0] ;
+  args_info->version_help = gengetopt_args_info_help[1] ;
+  args_info->input_help = gengetopt_args_info_help[2] ;
+  args_info->output_help = gengetopt_args_info_help[3] ;
+  args_info->index_bits_help = gengetopt_args_info_help[4] ;
+  args_info->memory_help = gengetopt_args_info_help[5] ;
+  args_info->tmpdir_help = gengetopt_args_info_help[6] ;
+  args_info->b_ncols_help = gengetopt_args_info_help[8] ;
+  args_info->b_used_ncols_help = gengetopt_args_info_help[9] ;
+  args_info->b_nents_col_help = gengetopt_args_info_help[10] ;
+  args_info->verbose_help = gengetopt_args_info_help[12] ;
+  
+}
+
+void
+cmdline_parser_print_version (void)
+{
+  printf ("%s %s\n",
+     (strlen(CMDLINE_PARSER_PACKAGE_NAME) ? CMDLINE_PARSER_PACKAGE_NAME : CMDLINE_PARSER_PACKAGE),
+     CMDLINE_PARSER_VERSION);
+
+  if (strlen(gengetopt_args_info_versiontext) > 0)
+    printf("\n%s\n", gengetopt_args_info_versiontext);
+}
+
+static void print_help_common(void)
+{
+	size_t len_purpose = strlen(gengetopt_args_info_purpose);
+	size_t len_usage = strlen(gengetopt_args_info_usage);
+
+	if (len_usage > 0) {
+		printf("%s\n", gengetopt_args_info_usage);
+	}
+	if (len_purpose > 0) {
+		printf("%s\n", gengetopt_args_info_purpose);
+	}
+
+	if (len_usage || len_purpose) {
+		printf("\n");
+	}
+
+	if (strlen(gengetopt_args_info_description) > 0) {
+		printf("%s\n\n", gengetopt_args_info_description);
+	}
+}
+
+void
+cmdline_parser_print_help (void)
+{
+  int i = 0;
+  print_help_common();
+  while (gengetopt_args_info_help[i])
+    printf("%s\n", gengetopt_args_info_help[i++]);
+}
+
+void
+cmdline_parser_init (struct gengetopt_args_info *args_info)
+{
+  clear_given (args_info);
+  clear_args (args_info);
+  init_args_info (args_info);
+}
+
+void
+cmdline_parser_params_init(struct cmdline_parser_params *params)
+{
+  if (params)
+    { 
+      params->override = 0;
+      params->initialize = 1;
+      params->check_required = 1;
+      params->check_ambiguity = 0;
+      params->print_errors = 1;
+    }
+}
+
+struct cmdline_parser_params *
+cmdline_parser_params_create(void)
+{
+  struct cmdline_parser_params *params = 
+    (struct cmdline_parser_params *)malloc(sizeof(struct cmdline_parser_params));
+  cmdline_parser_params_init(params);  
+  return params;
+}
+
+static void
+free_string_field (char **s)
+{
+  if (*s)
+    {
+      free (*s);
+      *s = 0;
+    }
+}
+
+
+static void
+cmdline_parser_release (struct gengetopt_args_info *args_info)
+{
+
+  free_string_field (&(args_info->input_arg));
+  free_string_field (&(args_info->input_orig));
+  free_string_field (&(args_info->output_arg));
+  free_string_field (&(args_info->output_orig));
+  free_string_field (&(args_info->index_bits_orig));
+  free_string_field (&(args_info->memory_orig));
+  free_string_field (&(args_info->tmpdir_arg));
+  free_string_field (&(args_info->tmpdir_orig));
+  free_string_field (&(args_info->b_ncols_orig));
+  free_string_field (&(args_info->b_used_ncols_orig));
+  free_string_field (&(args_info->b_nents_col_orig));
+  free_string_field (&(args_info->verbose_orig));
+  
+  
+
+  clear_given (args_info);
+}
+
+
+static void
+write_into_file(FILE *outfile, const char *opt, const char *arg, const char *values[])
+{
+  FIX_UNUSED (values);
+  if (arg) {
+    fprintf(outfile, "%s=\"%s\"\n", opt, arg);
+  } else {
+    fprintf(outfile, "%s\n", opt);
+  }
+}
+
+
+int
+cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
+{
+  int i = 0;
+
+  if (!outfile)
+    {
+      fprintf (stderr, "%s: cannot dump options to stream\n", CMDLINE_PARSER_PACKAGE);
+      return EXIT_FAILURE;
+    }
+
+  if (args_info->help_given)
+    write_into_file(outfile, "help", 0, 0 );
+  if (args_info->version_given)
+    write_into_file(outfile, "version", 0, 0 );
+  if (args_info->input_given)
+    write_into_file(outfile, "input", args_info->input_orig, 0);
+  if (args_info->output_given)
+    write_into_file(outfile, "output", args_info->output_orig, 0);
+  if (args_info->index_bits_given)
+    write_into_file(outfile, "index-bits", args_info->index_bits_orig, 0);
+  if (args_info->memory_given)
+    write_into_file(outfile, "memory", args_info->memory_orig, 0);
+  if (args_info->tmpdir_given)
+    write_into_file(outfile, "tmpdir", args_info->tmpdir_orig, 0);
+  if (args_info->b_ncols_given)
+    write_into_file(outfile, "b-ncols", args_info->b_ncols_orig, 0);
+  if (args_info->b_used_ncols_given)
+    write_into_file(outfile, "b-used-ncols", args_info->b_used_ncols_orig, 0);
+  if (args_info->b_nents_col_given)
+    write_into_file(outfile, "b-nents-col", args_info->b_nents_col_orig, 0);
+  if (args_info->verbose_given)
+    write_into_file(outfile, "verbose", args_info->verbose_orig, 0);
+  
+
+  i = EXIT_SUCCESS;
+  return i;
+}
+
+int
+cmdline_parser_file_save(const char *filename, struct gengetopt_args_info *args_info)
+{
+  FILE *outfile;
+  int i = 0;
+
+  outfile = fopen(filename, "w");
+
+  if (!outfile)
+    {
+      fprintf (stderr, "%s: cannot open file for writing: %s\n", CMDLINE_PARSER_PACKAGE, filename);
+      return EXIT_FAILURE;
+    }
+
+  i = cmdline_parser_dump(outfile, args_info);
+  fclose (outfile);
+
+  return i;
+}
+
+void
+cmdline_parser_free (struct gengetopt_args_info *args_info)
+{
+  cmdline_parser_release (args_info);
+}
+
+/** @brief replacement of strdup, which is not standard */
+char *
+gengetopt_strdup (const char *s)
+{
+  char *result = 0;
+  if (!s)
+    return result;
+
+  result = (char*)malloc(strlen(s) + 1);
+  if (result == (char*)0)
+    return (char*)0;
+  strcpy(result, s);
+  return result;
+}
+
+int
+cmdline_parser (int argc, char **argv, struct gengetopt_args_info *args_info)
+{
+  return cmdline_parser2 (argc, argv, args_info, 0, 1, 1);
+}
+
+int
+cmdline_parser_ext (int argc, char **argv, struct gengetopt_args_info *args_info,
+                   struct cmdline_parser_params *params)
+{
+  int result;
+  result = cmdline_parser_internal (argc, argv, args_info, params, 0);
+
+  if (result == EXIT_FAILURE)
+    {
+      cmdline_parser_free (args_info);
+      exit (EXIT_FAILURE);
+    }
+  
+  return result;
+}
+
+int
+cmdline_parser2 (int argc, char **argv, struct gengetopt_args_info *args_info, int override, int initialize, int check_required)
+{
+  int result;
+  struct cmdline_parser_params params;
+  
+  params.override = override;
+  params.initialize = initialize;
+  params.check_required = check_required;
+  params.check_ambiguity = 0;
+  params.print_errors = 1;
+
+  result = cmdline_parser_internal (argc, argv, args_info, &params, 0);
+
+  if (result == EXIT_FAILURE)
+    {
+      cmdline_parser_free (args_info);
+      exit (EXIT_FAILURE);
+    }
+  
+  return result;
+}
+
+int
+cmdline_parser_required (struct gengetopt_args_info *args_info, const char *prog_name)
+{
+  FIX_UNUSED (args_info);
+  FIX_UNUSED (prog_name);
+  return EXIT_SUCCESS;
+}
+
+
+static char *package_name = 0;
+
+/**
+ * @brief updates an option
+ * @param field the generic pointer to the field to update
+ * @param orig_field the pointer to the orig field
+ * @param field_given the pointer to the number of occurrence of this option
+ * @param prev_given the pointer to the number of occurrence already seen
+ * @param value the argument for this option (if null no arg was specified)
+ * @param possible_values the possible values for this option (if specified)
+ * @param default_value the default value (in case the option only accepts fixed values)
+ * @param arg_type the type of this option
+ * @param check_ambiguity @see cmdline_parser_params.check_ambiguity
+ * @param override @see cmdline_parser_params.override
+ * @param no_free whether to free a possible previous value
+ * @param multiple_option whether this is a multiple option
+ * @param long_opt the corresponding long option
+ * @param short_opt the corresponding short option (or '-' if none)
+ * @param additional_error possible further error specification
+ */
+static
+int update_arg(void *field, char **orig_field,
+               unsigned int *field_given, unsigned int *prev_given, 
+               char *value, const char *possible_values[],
+               const char *default_value,
+               cmdline_parser_arg_type arg_type,
+               int check_ambiguity, int override,
+               int no_free, int multiple_option,
+               const char *long_opt, char short_opt,
+               const char *additional_error)
+{
+  char *stop_char = 0;
+  const char *val = value;
+  int found;
+  char **string_field;
+  FIX_UNUSED (field);
+
+  stop_char = 0;
+  found = 0;
+
+  if (!multiple_option && prev_given && (*prev_given || (check_ambiguity && *field_given)))
+    {
+      if (short_opt != '-')
+        fprintf (stderr, "%s: `--%s' (`-%c') option given more than once%s\n", 
+               package_name, long_opt, short_opt,
+               (additional_error ? additional_error : ""));
+      else
+        fprintf (stderr, "%s: `--%s' option given more than once%s\n", 
+               package_name, long_opt,
+               (additional_error ? additional_error : ""));
+      return 1; /* failure */
+    }
+
+  FIX_UNUSED (default_value);
+    
+  if (field_given && *field_given && ! override)
+    return 0;
+  if (prev_given)
+    (*prev_given)++;
+  if (field_given)
+    (*field_given)++;
+  if (possible_values)
+    val = possible_values[found];
+
+  switch(arg_type) {
+  case ARG_FLAG:
+    *((int *)field) = !*((int *)field);
+    break;
+  case ARG_INT:
+    if (val) *((int *)field) = strtol (val, &stop_char, 0);
+    break;
+  case ARG_LONG:
+    if (val) *((long *)field) = (long)strtol (val, &stop_char, 0);
+    break;
+  case ARG_FLOAT:
+    if (val) *((float *)field) = (float)strtod (val, &stop_char);
+    break;
+  case ARG_STRING:
+    if (val) {
+      string_field = (char **)field;
+      if (!no_free && *string_field)
+        free (*string_field); /* free previous string */
+      *string_field = gengetopt_strdup (val);
+    }
+    break;
+  default:
+    break;
+  };
+
+  /* check numeric conversion */
+  switch(arg_type) {
+  case ARG_INT:
+  case ARG_LONG:
+  case ARG_FLOAT:
+    if (val && !(stop_char && *stop_char == '\0')) {
+      fprintf(stderr, "%s: invalid numeric value: %s\n", package_name, val);
+      return 1; /* failure */
+    }
+    break;
+  default:
+    ;
+  };
+
+  /* store the original value */
+  switch(arg_type) {
+  case ARG_NO:
+  case ARG_FLAG:
+    break;
+  default:
+    if (value && orig_field) {
+      if (no_free) {
+        *orig_field = value;
+      } else {
+        if (*orig_field)
+          free (*orig_field); /* free previous string */
+        *orig_field = gengetopt_strdup (value);
+      }
+    }
+  };
+
+  return 0; /* OK */
+}
+
+
+int
+cmdline_parser_internal (
+  int argc, char **argv, struct gengetopt_args_info *args_info,
+                        struct cmdline_parser_params *params, const char *additional_error)
+{
+  int c;	/* Character of the parsed option.  */
+
+  int error_occurred = 0;
+  struct gengetopt_args_info local_args_info;
+  
+  int override;
+  int initialize;
+  int check_required;
+  int check_ambiguity;
+  
+  package_name = argv[0];
+  
+  /* TODO: Why is this here? It is not used anywhere. */
+  override = params->override;
+  FIX_UNUSED(override);
+
+  initialize = params->initialize;
+  check_required = params->check_required;
+
+  /* TODO: Why is this here? It is not used anywhere. */
+  check_ambiguity = params->check_ambiguity;
+  FIX_UNUSED(check_ambiguity);
+
+  if (initialize)
+    cmdline_parser_init (args_info);
+
+  cmdline_parser_init (&local_args_info);
+
+  optarg = 0;
+  optind = 0;
+  opterr = params->print_errors;
+  optopt = '?';
+
+  while (1)
+    {
+      int option_index = 0;
+
+      static struct option long_options[] = {
+        { "help",	0, NULL, 'h' },
+        { "version",	0, NULL, 'V' },
+        { "input",	1, NULL, 'i' },
+        { "output",	1, NULL, 'o' },
+        { "index-bits",	1, NULL, 0 },
+        { "memory",	1, NULL, 'm' },
+        { "tmpdir",	1, NULL, 0 },
+        { "b-ncols",	1, NULL, 'c' },
+        { "b-used-ncols",	1, NULL, 'C' },
+        { "b-nents-col",	1, NULL, 'E' },
+        { "verbose",	2, NULL, 0 },
+        { 0,  0, 0, 0 }
+      };
+
+      c = getopt_long (argc, argv, "hVi:o:m:c:C:E:", long_options, &option_index);
+
+      if (c == -1) break;	/* Exit from `while (1)' loop.  */
+
+      switch (c)
+        {
+        case 'h':	/* Print help and exit.  */
+          cmdline_parser_print_help ();
+          cmdline_parser_free (&local_args_info);
+          exit (EXIT_SUCCESS);
+
+        case 'V':	/* Print version and exit.  */
+          cmdline_parser_print_version ();
+          cmdline_parser_free (&local_args_info);
+          exit (EXIT_SUCCESS);
+
+        case 'i':	/* Edge list from el-generator --binary: el64, el32, or wel64.  */
+        
+        
+          if (update_arg( (void *)&(args_info->input_arg), 
+               &(args_info->input_orig), &(args_info->input_given),
+              &(local_args_info.input_given), optarg, 0, 0, ARG_STRING,
+              check_ambiguity, override, 0, 0,
+              "input", 'i',
+              additional_error))
+            goto failure;
+        
+          break;
+        case 'o':	/* Binary CSR file for GrB-mxm-timer --binary --filename.  */
+        
+        
+          if (update_arg( (void *)&(args_info->output_arg), 
+               &(args_info->output_orig), &(args_info->output_given),
+              &(local_args_info.output_given), optarg, 0, 0, ARG_STRING,
+              check_ambiguity, override, 0, 0,
+              "output", 'o',
+              additional_error))
+            goto failure;
+        
+          break;
+        case 'm':	/* MiB per bucket pass, which sets the number of buckets (0: half of physical memory).  */
+        
+        
+          if (update_arg( (void *)&(args_info->memory_arg), 
+               &(args_info->memory_orig), &(args_info->memory_given),
+              &(local_args_info.memory_given), optarg, 0, "0", ARG_LONG,
+              check_ambiguity, override, 0, 0,
+              "memory", 'm',
+              additional_error))
+            goto failure;
+        
+          break;
+        case 'c':	/* Number of columns in B.  */
+        
+        
+          if (update_arg( (void *)&(args_info->b_ncols_arg), 
+               &(args_info->b_ncols_orig), &(args_info->b_ncols_given),
+              &(local_args_info.b_ncols_given), optarg, 0, "16", ARG_INT,
+              check_ambiguity, override, 0, 0,
+              "b-ncols", 'c',
+              additional_error))
+            goto failure;
+        
+          break;
+        case 'C':	/* Number of columns actually used in the initial B.  */
+        
+        
+          if (update_arg( (void *)&(args_info->b_used_ncols_arg), 
+               &(args_info->b_used_ncols_orig), &(args_info->b_used_ncols_given),
+              &(local_args_info.b_used_ncols_given), optarg, 0, "1", ARG_INT,
+              check_ambiguity, override, 0, 0,
+              "b-used-ncols", 'C',
+              additional_error))
+            goto failure;
+        
+          break;
+        case 'E':	/* Number of entries per column in the initial B.  */
+        
+        
+          if (update_arg( (void *)&(args_info->b_nents_col_arg), 
+               &(args_info->b_nents_col_orig), &(args_info->b_nents_col_given),
+              &(local_args_info.b_nents_col_given), optarg, 0, "1", ARG_INT,
+              check_ambiguity, override, 0, 0,
+              "b-nents-col", 'E',
+              additional_error))
+            goto failure;
+        
+          break;
+
+        case 0:	/* Long option with no short option */
+          /* Column index width in the output: 64 or 32.  */
+          if (strcmp (long_options[option_index].name, "index-bits") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->index_bits_arg), 
+                 &(args_info->index_bits_orig), &(args_info->index_bits_given),
+                &(local_args_info.index_bits_given), optarg, 0, "64", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "index-bits", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Directory for the spilled buckets.  */
+          else if (strcmp (long_options[option_index].name, "tmpdir") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->tmpdir_arg), 
+                 &(args_info->tmpdir_orig), &(args_info->tmpdir_given),
+                &(local_args_info.tmpdir_given), optarg, 0, ".", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "tmpdir", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Provide status updates via stdout..  */
+          else if (strcmp (long_options[option_index].name, "verbose") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->verbose_arg), 
+                 &(args_info->verbose_orig), &(args_info->verbose_given),
+                &(local_args_info.verbose_given), optarg, 0, "1", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "verbose", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          
+          break;
+        case '?':	/* Invalid option.  */
+          /* `getopt_long' already printed an error message.  */
+          goto failure;
+
+        default:	/* bug: option not considered.  */
+          fprintf (stderr, "%s: option unknown: %c%s\n", CMDLINE_PARSER_PACKAGE, c, (additional_error ? additional_error : ""));
+          abort ();
+        } /* switch */
+    } /* while */
+
+
+
+	FIX_UNUSED(check_required);
+
+  cmdline_parser_release (&local_args_info);
+
+  if ( error_occurred )
+    return (EXIT_FAILURE);
+
+  return 0;
+
+failure:
+  
+  cmdline_parser_release (&local_args_info);
+  return (EXIT_FAILURE);
+}
+/* vim: set ft=c noet ts=8 sts=8 sw=8 tw=80 nojs spell : */
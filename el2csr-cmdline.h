@@ -0,0 +1,209 @@
+/** @file el2csr-cmdline.h
+ *  @brief The header file for the command line option parser
+ *  generated by GNU Gengetopt version 2.23
+ *  http://www.gnu.org/software/gengetopt.
+ *  DO NOT modify this file, since it can be overwritten
+ *  @author GNU Gengetopt */
+
+#ifndef EL2CSR_CMDLINE_H
+#define EL2CSR_CMDLINE_H
+
+/* If we use autoconf.  */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h> /* for FILE */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#ifndef CMDLINE_PARSER_PACKAGE
+/** @brief the program name (used for printing errors) */
+#define CMDLINE_PARSER_PACKAGE "el2csr"
+#endif
+
+#ifndef CMDLINE_PARSER_PACKAGE_NAME
+/** @brief the complete program name (used for help and version) */
+#define CMDLINE_PARSER_PACKAGE_NAME "el2csr"
+#endif
+
+#ifndef CMDLINE_PARSER_VERSION
+/** @brief the program version */
+#define CMDLINE_PARSER_VERSION "0"
+#endif
+
+/** @brief Where the command line options are stored */
+struct gengetopt_args_info
+{
+  const char *help_help; /**< @brief Print help and exit help description.  */
+  const char *version_help; /**< @brief Print version and exit help description.  */
+  char * input_arg;	/**< @brief Edge list from el-generator --binary: el64, el32, or wel64.  */
+  char * input_orig;	/**< @brief Edge list from el-generator --binary: el64, el32, or wel64 original value given at command line.  */
+  const char *input_help; /**< @brief Edge list from el-generator --binary: el64, el32, or wel64 help description.  */
+  char * output_arg;	/**< @brief Binary CSR file for GrB-mxm-timer --binary --filename.  */
+  char * output_orig;	/**< @brief Binary CSR file for GrB-mxm-timer --binary --filename original value given at command line.  */
+  const char *output_help; /**< @brief Binary CSR file for GrB-mxm-timer --binary --filename help description.  */
+  int index_bits_arg;	/**< @brief Column index width in the output: 64 or 32 (default='64').  */
+  char * index_bits_orig;	/**< @brief Column index width in the output: 64 or 32 original value given at command line.  */
+  const char *index_bits_help; /**< @brief Column index width in the output: 64 or 32 help description.  */
+  long memory_arg;	/**< @brief MiB per bucket pass, which sets the number of buckets (0: half of physical memory) (default='0').  */
+  char * memory_orig;	/**< @brief MiB per bucket pass, which sets the number of buckets (0: half of physical memory) original value given at command line.  */
+  const char *memory_help; /**< @brief MiB per bucket pass, which sets the number of buckets (0: half of physical memory) help description.  */
+  char * tmpdir_arg;	/**< @brief Directory for the spilled buckets (default='.').  */
+  char * tmpdir_orig;	/**< @brief Directory for the spilled buckets original value given at command line.  */
+  const char *tmpdir_help; /**< @brief Directory for the spilled buckets help description.  */
+  int b_ncols_arg;	/**< @brief Number of columns in B (default='16').  */
+  char * b_ncols_orig;	/**< @brief Number of columns in B original value given at command line.  */
+  const char *b_ncols_help; /**< @brief Number of columns in B help description.  */
+  int b_used_ncols_arg;	/**< @brief Number of columns actually used in the initial B (default='1').  */
+  char * b_used_ncols_orig;	/**< @brief Number of columns actually used in the initial B original value given at command line.  */
+  const char *b_used_ncols_help; /**< @brief Number of columns actually used in the initial B help description.  */
+  int b_nents_col_arg;	/**< @brief Number of entries per column in the initial B (default='1').  */
+  char * b_nents_col_orig;	/**< @brief Number of entries per column in the initial B original value given at command line.  */
+  const char *b_nents_col_help; /**< @brief Number of entries per column in the initial B help description.  */
+  int verbose_arg;	/**< @brief Provide status updates via stdout. (default='1').  */
+  char * verbose_orig;	/**< @brief Provide status updates via stdout. original value given at command line.  */
+  const char *verbose_help; /**< @brief Provide status updates via stdout. help description.  */
+  
+  unsigned int help_given ;	/**< @brief Whether help was given.  */
+  unsigned int version_given ;	/**< @brief Whether version was given.  */
+  unsigned int input_given ;	/**< @brief Whether input was given.  */
+  unsigned int output_given ;	/**< @brief Whether output was given.  */
+  unsigned int index_bits_given ;	/**< @brief Whether index-bits was given.  */
+  unsigned int memory_given ;	/**< @brief Whether memory was given.  */
+  unsigned int tmpdir_given ;	/**< @brief Whether tmpdir was given.  */
+  unsigned int b_ncols_given ;	/**< @brief Whether b-ncols was given.  */
+  unsigned int b_used_ncols_given ;	/**< @brief Whether b-used-ncols was given.  */
+  unsigned int b_nents_col_given ;	/**< @brief Whether b-nents-col was given.  */
+  unsigned int verbose_given ;	/**< @brief Whether verbose was given.  */
+
+} ;
+
+/** @brief The additional parameters to pass to parser functions */
+struct cmdline_parser_params
+{
+  int override; /**< @brief whether to override possibly already present options (default 0) */
+  int initialize; /**< @brief whether to initialize the option structure gengetopt_args_info (default 1) */
+  int check_required; /**< @brief whether to check that all required options were provided (default 1) */
+  int check_ambiguity; /**< @brief whether to check for options already specified in the option structure gengetopt_args_info (default 0) */
+  int print_errors; /**< @brief whether getopt_long should print an error message for a bad option (default 1) */
+} ;
+
+/** @brief the purpose string of the program */
+extern const char *gengetopt_args_info_purpose;
+/** @brief the usage string of the program */
+extern const char *gengetopt_args_info_usage;
+/** @brief the description string of the program */
+extern const char *gengetopt_args_info_description;
+/** @brief all the lines making the help output */
+extern const char *gengetopt_args_info_help[];
+
+/**
+ * The command line parser
+ * @param argc the number of command line options
+ * @param argv the command line options
+ * @param args_info the structure where option information will be stored
+ * @return 0 if everything went fine, NON 0 if an error took place
+ */
+int cmdline_parser (int argc, char **argv,
+  struct gengetopt_args_info *args_info);
+
+/**
+ * The command line parser (version with additional parameters - deprecated)
+ * @param argc the number of command line options
+ * @param argv the command line options
+ * @param args_info the structure where option information will be stored
+ * @param override whether to override possibly already present options
+ * @param initialize whether to initialize the option structure my_args_info
+ * @param check_required whether to check that all required options were provided
+ * @return 0 if everything went fine, NON 0 if an error took place
+ * @deprecated use cmdline_parser_ext() instead
+ */
+int cmdline_parser2 (int argc, char **argv,
+  struct gengetopt_args_info *args_info,
+  int override, int initialize, int check_required);
+
+/**
+ * The command line parser (version with additional parameters)
+ * @param argc the number of command line options
+ * @param argv the command line options
+ * @param args_info the structure where option information will be stored
+ * @param params additional parameters for the parser
+ * @return 0 if everything went fine, NON 0 if an error took place
+ */
+int cmdline_parser_ext (int argc, char **argv,
+  struct gengetopt_args_info *args_info,
+  struct cmdline_parser_params *params);
+
+/**
+ * Save the contents of the option struct into an already open FILE stream.
+ * @param outfile the stream where to dump options
+ * @param args_info the option struct to dump
+ * @return 0 if everything went fine, NON 0 if an error took place
+ */
+int cmdline_parser_dump(FILE *outfile,
+  struct gengetopt_args_info *args_info);
+
+/**
+ * Save the contents of the option struct into a (text) file.
+ * This file can be read by the config file parser (if generated by gengetopt)
+ * @param filename the file where to save
+ * @param args_info the option struct to save
+ * @return 0 if everything went fine, NON 0 if an error took place
+ */
+int cmdline_parser_file_save(const char *filename,
+  struct gengetopt_args_info *args_info);
+
+/**
+ * Print the help
+ */
+void cmdline_parser_print_help(void);
+/**
+ * Print the version
+ */
+void cmdline_parser_print_version(void);
+
+/**
+ * Initializes all the fields a cmdline_parser_params structure 
+ * to their default values
+ * @param params the structure to initialize
+ */
+void cmdline_parser_params_init(struct cmdline_parser_params *params);
+
+/**
+ * Allocates dynamically a cmdline_parser_params structure and initializes
+ * all its fields to their default values
+ * @return the created and initialized cmdline_parser_params structure
+ */
+struct cmdline_parser_params *cmdline_parser_params_create(void);
+
+/**
+ * Initializes the passed gengetopt_args_info structure's fields
+ * (also set default values for options that have a default)
+ * @param args_info the structure to initialize
+ */
+void cmdline_parser_init (struct gengetopt_args_info *args_info);
+/**
+ * Deallocates the string fields of the gengetopt_args_info structure
+ * (but does not deallocate the structure itself)
+ * @param args_info the structure to deallocate
+ */
+void cmdline_parser_free (struct gengetopt_args_info *args_info);
+
+/**
+ * Checks that all the required options were specified
+ * @param args_info the structure to check
+ * @param prog_name the name of the program that will be used to print
+ *   possible errors
+ * @return
+ */
+int cmdline_parser_required (struct gengetopt_args_info *args_info,
+  const char *prog_name);
+
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* EL2CSR_CMDLINE_H */
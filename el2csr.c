@@ -0,0 +1,455 @@
+/* -*- C -*- */
+#define _GNU_SOURCE
+#include "compat.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "el2csr-cmdline.h"
+#include "generator.h"  // for EDGE_FINGERPRINT_LEN
+#include "globals.h"
+#include "prng.h"  // for sample_roots
+
+/* Converts a binary edge list from el-generator into the file
+   GrB-mxm-timer --binary reads: A in CSR, then the initial B that the
+   timer's make_B would build.  The list may be larger than memory.  A
+   first pass scatters the edges into temporary files by range of rows;
+   each bucket is then loaded on its own, counting-sorted by row, each
+   row sorted by column, and its slices of the offsets and column indices
+   written in place.  Values go to one more temporary file and are copied
+   behind the column indices at the end, once the entry count is known.
+   As with GrB_Matrix_build and GrB_FIRST_UINT64, the first of repeated
+   edges is kept. */
+
+int verbose = 0;
+
+struct gengetopt_args_info args;
+
+enum el_format { EL_32, EL_64, EL_W64 };
+
+// Edges decoded per read of the input.
+#define READ_EDGES (1 << 20)
+// Edges staged per bucket before a write to its file.
+#define SPILL_EDGES 8192
+// Bytes per edge while a bucket is sorted: the loaded (i, j, w)
+// triples, then the (col, val, pos) entries.
+#define EDGE_BYTES 48
+// Bytes per row of a bucket: its end before and length after sorting.
+#define ROW_BYTES 16
+// Room for buckets that come out larger than the average.
+#define BUCKET_SLACK 2
+// Rows of B's offsets per write.
+#define OFF_BLOCK (1 << 16)
+
+static const char filetag[] = "mxmtimer";
+static const char filetag32[] = "mxmtim32";
+
+struct entry {
+  uint64_t col, val, pos;
+};
+
+static void write_all(int fd, const void *buf, size_t len, off_t off) {
+  const char *p = buf;
+  while (len) {
+    const ssize_t n = pwrite(fd, p, len, off);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) DIE_PERROR("Error writing \"%s\": ", args.output_arg);
+    p += n;
+    len -= n;
+    off += n;
+  }
+}
+
+static void read_all(int fd, void *buf, size_t len, off_t off,
+                     const char *what) {
+  char *p = buf;
+  while (len) {
+    const ssize_t n = pread(fd, p, len, off);
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) DIE_PERROR("Error reading %s: ", what);
+    if (n == 0) DIE("Unexpected end of %s\n", what);
+    p += n;
+    len -= n;
+    off += n;
+  }
+}
+
+static int make_tmp(const char *tmpdir) {
+  char path[PATH_MAX];
+  snprintf(path, sizeof(path), "%s/el2csr-XXXXXX", tmpdir);
+  const int fd = mkstemp(path);
+  if (fd < 0) DIE_PERROR("Cannot create \"%s\": ", path);
+  unlink(path); // gone when closed
+  return fd;
+}
+
+/* The header line el-generator writes ahead of a binary list.  The
+   list's fingerprint, if the header has one, goes to fp, and the seeds
+   it names overwrite those in seeds.  Returns the offset of the first
+   edge. */
+static off_t read_header(int fd, enum el_format *fmt, uint64_t *ne,
+                         uint64_t *nv, char fp[EDGE_FINGERPRINT_LEN + 1],
+                         uint64_t seeds[4]) {
+  char buf[4096];
+  ssize_t len = pread(fd, buf, sizeof(buf) - 1, 0);
+  if (len < 0) DIE_PERROR("Error reading \"%s\": ", args.input_arg);
+  buf[len] = '\0';
+  char *end = memchr(buf, '\n', len);
+  if (!end) DIE("No header line in \"%s\"\n", args.input_arg);
+  *end = '\0';
+
+  char name[16];
+  const char *p;
+  if (!(p = strstr(buf, "--format ")) || 1 != sscanf(p, "--format %15s", name))
+    DIE("No --format in the header of \"%s\"\n", args.input_arg);
+  if (!strcmp(name, "el32"))
+    *fmt = EL_32;
+  else if (!strcmp(name, "el64"))
+    *fmt = EL_64;
+  else if (!strcmp(name, "wel64"))
+    *fmt = EL_W64;
+  else
+    DIE("Unsupported format \"%s\" (el32, el64, wel64)\n", name);
+  if (!(p = strstr(buf, "--num_edges ")) ||
+      1 != sscanf(p, "--num_edges %lu", (unsigned long *)ne))
+    DIE("No --num_edges in the header of \"%s\"\n", args.input_arg);
+  if (!(p = strstr(buf, "--num_vertices ")) ||
+      1 != sscanf(p, "--num_vertices %lu", (unsigned long *)nv))
+    DIE("No --num_vertices in the header of \"%s\"\n", args.input_arg);
+  fp[0] = '\0';
+  if ((p = strstr(buf, "--fingerprint ")))
+    sscanf(p, "--fingerprint %33s", fp);
+  for (int k = 0; k < 4; ++k) {
+    char opt[16];
+    unsigned long s;
+    snprintf(opt, sizeof(opt), "--seed%d ", k);
+    if ((p = strstr(buf, opt)) && 1 == sscanf(p + strlen(opt), "%lu", &s))
+      seeds[k] = s;
+  }
+  return end - buf + 1;
+}
+
+static size_t edge_bytes(enum el_format fmt) {
+  return fmt == EL_32 ? 2 * sizeof(uint32_t)
+                      : (fmt == EL_W64 ? 3 : 2) * sizeof(uint64_t);
+}
+
+/* Decode n edges from buf into (i, j, w) triples; w is 1 unless the
+   list carries weights. */
+static void decode(uint64_t *e, const char *buf, uint64_t n,
+                   enum el_format fmt, uint64_t nv, uint64_t first) {
+  OMP(parallel for)
+  for (uint64_t k = 0; k < n; ++k) {
+    uint64_t i, j, w = 1;
+    if (fmt == EL_32) {
+      uint32_t ij[2];
+      memcpy(ij, buf + k * sizeof(ij), sizeof(ij));
+      i = ij[0];
+      j = ij[1];
+    } else {
+      uint64_t ijw[3];
+      memcpy(ijw, buf + k * edge_bytes(fmt), edge_bytes(fmt));
+      i = ijw[0];
+      j = ijw[1];
+      if (fmt == EL_W64) w = ijw[2];
+    }
+    if (i >= nv || j >= nv)
+      DIE("Edge %lu (%lu, %lu) is out of range\n", (unsigned long)(first + k),
+          (unsigned long)i, (unsigned long)j);
+    e[3 * k] = i;
+    e[3 * k + 1] = j;
+    e[3 * k + 2] = w;
+  }
+}
+
+static int entry_cmp(const void *a_, const void *b_) {
+  const struct entry *a = a_, *b = b_;
+  if (a->col != b->col) return a->col < b->col ? -1 : 1;
+  return a->pos < b->pos ? -1 : a->pos > b->pos;
+}
+
+/* Sort one row by column, keeping input order among repeats, and drop
+   all but the first of each column.  Returns the new length. */
+static uint64_t sort_row(struct entry *r, uint64_t n) {
+  if (n < 2) return n;
+  if (n <= 16) {
+    for (uint64_t k = 1; k < n; ++k) {
+      const struct entry t = r[k];
+      uint64_t m = k;
+      for (; m > 0 && r[m - 1].col > t.col; --m) r[m] = r[m - 1];
+      r[m] = t;
+    }
+  } else
+    qsort(r, n, sizeof(*r), entry_cmp);
+  uint64_t out = 1;
+  for (uint64_t k = 1; k < n; ++k)
+    if (r[k].col != r[out - 1].col) r[out++] = r[k];
+  return out;
+}
+
+/* Rows [row_begin, row_begin + nr) from the n triples in e: writes
+   their offsets (counting from base) and column indices in place in the
+   output, appends their values to valfd, and returns the entry count.
+   The triples' space is reused for the packed columns and values. */
+static uint64_t convert_bucket(int out, int valfd, off_t off_pos,
+                               off_t colind_pos, size_t colind_bytes,
+                               uint64_t row_begin, uint64_t nr, uint64_t base,
+                               uint64_t *e, uint64_t n, struct entry *s,
+                               uint64_t *rowend, uint64_t *len) {
+  memset(rowend, 0, nr * sizeof(*rowend));
+  for (uint64_t k = 0; k < n; ++k) ++rowend[e[3 * k] - row_begin];
+  for (uint64_t r = 0, sum = 0; r < nr; ++r) {
+    sum += rowend[r];
+    rowend[r] = sum - rowend[r];
+  }
+  for (uint64_t k = 0; k < n; ++k) {
+    const uint64_t at = rowend[e[3 * k] - row_begin]++;
+    s[at].col = e[3 * k + 1];
+    s[at].val = e[3 * k + 2];
+    s[at].pos = k;
+  }
+
+  OMP(parallel for schedule(dynamic, 1024))
+  for (uint64_t r = 0; r < nr; ++r) {
+    const uint64_t begin = r ? rowend[r - 1] : 0;
+    len[r] = sort_row(s + begin, rowend[r] - begin);
+  }
+  uint64_t nnz = 0;
+  for (uint64_t r = 0; r < nr; ++r) {
+    const uint64_t t = len[r];
+    len[r] = nnz;
+    nnz += t;
+  }
+
+  uint64_t *col = e, *val = e + n;
+  OMP(parallel for schedule(dynamic, 1024))
+  for (uint64_t r = 0; r < nr; ++r) {
+    const uint64_t begin = r ? rowend[r - 1] : 0;
+    const uint64_t rlen = (r + 1 < nr ? len[r + 1] : nnz) - len[r];
+    for (uint64_t k = 0; k < rlen; ++k) {
+      col[len[r] + k] = s[begin + k].col;
+      val[len[r] + k] = s[begin + k].val;
+    }
+  }
+
+  parfor (uint64_t r = 0; r < nr; ++r) len[r] += base;
+  write_all(out, len, nr * sizeof(*len), off_pos + row_begin * sizeof(*len));
+  if (colind_bytes == sizeof(uint32_t)) {
+    // Narrow in place; each store lands at or below its load.
+    uint32_t *col32 = (uint32_t *)col;
+    for (uint64_t k = 0; k < nnz; ++k) col32[k] = col[k];
+  }
+  write_all(out, col, nnz * colind_bytes, colind_pos + base * colind_bytes);
+  write_all(valfd, val, nnz * sizeof(*val), base * sizeof(*val));
+  return nnz;
+}
+
+/* Append the timer's initial B behind A, at pos: NV rows, one entry of
+   1 in row root k at column k / nents.  The roots come out of
+   sample_roots sorted and distinct. */
+static void write_B(int out, off_t pos, uint64_t nv, int colind32,
+                    int64_t ncols, int64_t used_ncols, int nents) {
+  const int64_t nroot = used_ncols * nents;
+  if (nroot > (int64_t)nv)
+    DIE("B needs %ld roots but A has %lu rows\n", (long)nroot,
+        (unsigned long)nv);
+  int64_t *root = malloc((nroot ? nroot : 1) * sizeof(*root));
+  uint64_t *blk = malloc(OFF_BLOCK * sizeof(*blk));
+  if (!root || !blk) DIE_PERROR("Cannot malloc B: ");
+  NV = nv;
+  // The key is the list's, so the roots match the timer's make_B.
+  sample_roots(root, nroot, NV * used_ncols * nents);
+
+  const uint64_t head[5] = {2, 0, nv, ncols, nroot};
+  write_all(out, colind32 ? filetag32 : filetag, 8, pos);
+  write_all(out, &head[0], 8, pos + 8);
+  write_all(out, "B", 2, pos + 16);
+  write_all(out, &head[2], 3 * 8, pos + 18);
+  pos += 18 + 3 * 8;
+
+  int64_t k = 0;
+  for (uint64_t r0 = 0; r0 <= nv; r0 += OFF_BLOCK) {
+    const uint64_t nb = nv + 1 - r0 < OFF_BLOCK ? nv + 1 - r0 : OFF_BLOCK;
+    for (uint64_t r = 0; r < nb; ++r) {
+      while (k < nroot && (uint64_t)root[k] < r0 + r) ++k;
+      blk[r] = k;
+    }
+    write_all(out, blk, nb * sizeof(*blk), pos);
+    pos += nb * sizeof(*blk);
+  }
+  uint64_t *col = (uint64_t *)root;
+  for (k = 0; k < nroot; ++k) col[k] = k / nents;
+  if (colind32)
+    for (k = 0; k < nroot; ++k) ((uint32_t *)col)[k] = col[k];
+  write_all(out, col, nroot * (colind32 ? 4 : 8), pos);
+  pos += nroot * (colind32 ? 4 : 8);
+  for (k = 0; k < nroot; ++k) col[k] = 1;
+  write_all(out, col, nroot * sizeof(*col), pos);
+  free(blk);
+  free(root);
+}
+
+int main(int argc, char **argv) {
+  if (0 != cmdline_parser(argc, argv, &args)) exit(1);
+  if (NULL != getenv("VERBOSE")) {
+    long lvl = strtol(getenv("VERBOSE"), NULL, 10);
+    if (lvl > 1) verbose = lvl;
+  }
+  if (args.verbose_given) verbose = args.verbose_arg;
+
+  if (!args.input_given || !args.output_given)
+    DIE("el2csr needs --input and --output\n");
+  if (args.index_bits_arg != 32 && args.index_bits_arg != 64)
+    DIE("--index-bits must be 32 or 64\n");
+  if (args.memory_arg < 0) DIE("--memory must be nonnegative\n");
+  if (args.b_ncols_arg <= 0 || args.b_used_ncols_arg < 0 ||
+      args.b_used_ncols_arg > args.b_ncols_arg || args.b_nents_col_arg <= 0)
+    DIE("Invalid shape for B\n");
+
+  const int in = open(args.input_arg, O_RDONLY);
+  if (in < 0) DIE_PERROR("Error opening \"%s\": ", args.input_arg);
+  enum el_format fmt;
+  uint64_t ne, nv;
+  char fp[EDGE_FINGERPRINT_LEN + 1];
+  // B's roots are drawn with the seeds the list was generated with.
+  uint64_t env_seeds[4], seeds[4];
+  init_prng(env_seeds);
+  memcpy(seeds, env_seeds, sizeof(seeds));
+  const off_t data_pos = read_header(in, &fmt, &ne, &nv, fp, seeds);
+  for (int k = 0; k < 4; ++k) {
+    char var[8];
+    snprintf(var, sizeof(var), "SEED%d", k);
+    if (getenv(var) && seeds[k] != env_seeds[k])
+      DIE("%s=%lu, but \"%s\" was generated with --seed%d %lu\n", var,
+          (unsigned long)env_seeds[k], args.input_arg, k,
+          (unsigned long)seeds[k]);
+  }
+  prng_set_seeds(seeds);
+  const size_t eb = edge_bytes(fmt);
+  struct stat st;
+  if (fstat(in, &st)) DIE_PERROR("Cannot stat \"%s\": ", args.input_arg);
+  if ((uint64_t)st.st_size != data_pos + ne * eb)
+    DIE("\"%s\" holds %lu bytes of edges, not %lu edges of %zu bytes\n",
+        args.input_arg, (unsigned long)(st.st_size - data_pos),
+        (unsigned long)ne, eb);
+  const int colind32 = args.index_bits_arg == 32;
+  if (colind32 && nv > (uint64_t)UINT32_MAX + 1)
+    DIE("A has too many columns for 32-bit indices\n");
+  const size_t colind_bytes = colind32 ? sizeof(uint32_t) : sizeof(uint64_t);
+
+  uint64_t mem = (uint64_t)args.memory_arg << 20;
+  if (!mem) mem = (uint64_t)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE) / 2;
+  uint64_t nbucket =
+      (BUCKET_SLACK * ne * EDGE_BYTES + nv * ROW_BYTES + mem - 1) / mem;
+  if (nbucket < 1) nbucket = 1;
+  const uint64_t range = nv > nbucket ? (nv + nbucket - 1) / nbucket : 1;
+  nbucket = nv > range ? (nv + range - 1) / range : 1;
+  VERBOSE_PRINT("%lu edges, %lu vertices, %lu bucket(s) of %lu rows\n",
+                (unsigned long)ne, (unsigned long)nv, (unsigned long)nbucket,
+                (unsigned long)range);
+
+  // Pass 1: scatter (i, j, w) triples to the buckets' files.
+  int *fd = malloc(nbucket * sizeof(*fd));
+  uint64_t *count = calloc(nbucket, sizeof(*count));
+  uint64_t *fill = calloc(nbucket, sizeof(*fill));
+  uint64_t *stage = malloc(nbucket * SPILL_EDGES * 3 * sizeof(*stage));
+  char *buf = malloc(READ_EDGES * eb);
+  uint64_t *e = malloc(READ_EDGES * 3 * sizeof(*e));
+  if (!fd || !count || !fill || !stage || !buf || !e)
+    DIE_PERROR("Cannot malloc buckets: ");
+  for (uint64_t b = 0; b < nbucket; ++b) fd[b] = make_tmp(args.tmpdir_arg);
+  for (uint64_t first = 0; first < ne; first += READ_EDGES) {
+    const uint64_t n = ne - first < READ_EDGES ? ne - first : READ_EDGES;
+    read_all(in, buf, n * eb, data_pos + first * eb, "the edge list");
+    decode(e, buf, n, fmt, nv, first);
+    for (uint64_t k = 0; k < n; ++k) {
+      const uint64_t b = e[3 * k] / range;
+      uint64_t *stb = stage + b * SPILL_EDGES * 3;
+      memcpy(stb + 3 * fill[b], e + 3 * k, 3 * sizeof(*e));
+      if (++fill[b] == SPILL_EDGES) {
+        write_all(fd[b], stb, sizeof(*stb) * 3 * SPILL_EDGES,
+                  count[b] * 3 * sizeof(*stb));
+        count[b] += SPILL_EDGES;
+        fill[b] = 0;
+      }
+    }
+  }
+  uint64_t max_count = 0;
+  for (uint64_t b = 0; b < nbucket; ++b) {
+    write_all(fd[b], stage + b * SPILL_EDGES * 3,
+              sizeof(*stage) * 3 * fill[b], count[b] * 3 * sizeof(*stage));
+    count[b] += fill[b];
+    if (count[b] > max_count) max_count = count[b];
+  }
+  close(in);
+  free(e);
+  free(buf);
+  free(stage);
+  free(fill);
+
+  // Pass 2: each bucket's rows of A, in row order.
+  const int out = open(args.output_arg, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (out < 0) DIE_PERROR("Error opening \"%s\": ", args.output_arg);
+  const int valfd = make_tmp(args.tmpdir_arg);
+  // As in the timer's dump, A's name carries the list's fingerprint.
+  char name[64] = "A";
+  if (fp[0]) snprintf(name, sizeof(name), "A --fingerprint %s", fp);
+  const uint64_t head[5] = {strlen(name) + 1, 0, nv, nv, 0};
+  const off_t dims_pos = 16 + head[0];
+  write_all(out, colind32 ? filetag32 : filetag, 8, 0);
+  write_all(out, &head[0], 8, 8);
+  write_all(out, name, head[0], 16);
+  write_all(out, &head[2], 3 * 8, dims_pos);
+  const off_t off_pos = dims_pos + 3 * 8;
+  const off_t colind_pos = off_pos + (nv + 1) * sizeof(uint64_t);
+
+  e = malloc((max_count ? max_count : 1) * 3 * sizeof(*e));
+  struct entry *s = malloc((max_count ? max_count : 1) * sizeof(*s));
+  uint64_t *rowend = malloc(range * sizeof(*rowend));
+  uint64_t *len = malloc(range * sizeof(*len));
+  if (!e || !s || !rowend || !len) DIE_PERROR("Cannot malloc a bucket: ");
+  uint64_t nnz = 0;
+  for (uint64_t b = 0; b < nbucket; ++b) {
+    const uint64_t row_begin = b * range;
+    const uint64_t nr = nv - row_begin < range ? nv - row_begin : range;
+    read_all(fd[b], e, count[b] * 3 * sizeof(*e), 0, "a bucket");
+    close(fd[b]);
+    nnz += convert_bucket(out, valfd, off_pos, colind_pos, colind_bytes,
+                          row_begin, nr, nnz, e, count[b], s, rowend, len);
+    VERBOSELVL_PRINT(2, "  bucket %lu/%lu: %lu entries so far\n",
+                     (unsigned long)b + 1, (unsigned long)nbucket,
+                     (unsigned long)nnz);
+  }
+  free(len);
+  free(rowend);
+  free(s);
+  free(count);
+  free(fd);
+
+  write_all(out, &nnz, 8, off_pos + nv * sizeof(nnz));
+  write_all(out, &nnz, 8, dims_pos + 2 * 8);
+  // The values, behind the column indices.
+  const off_t val_pos = colind_pos + nnz * colind_bytes;
+  const uint64_t copy = max_count ? 3 * max_count : 1;
+  for (uint64_t k = 0; k < nnz; k += copy) {
+    const uint64_t n = nnz - k < copy ? nnz - k : copy;
+    read_all(valfd, e, n * sizeof(*e), k * sizeof(*e), "the values");
+    write_all(out, e, n * sizeof(*e), val_pos + k * sizeof(*e));
+  }
+  close(valfd);
+  free(e);
+  VERBOSE_PRINT("A: %lu entries\n", (unsigned long)nnz);
+
+  write_B(out, val_pos + nnz * sizeof(uint64_t), nv, colind32,
+          args.b_ncols_arg, args.b_used_ncols_arg, args.b_nents_col_arg);
+  if (close(out)) DIE_PERROR("Error closing \"%s\": ", args.output_arg);
+  cmdline_parser_free(&args);
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include "compat.h"
+#include "elsort.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RADIX 256
+
+int elsort_pairs(uint64_t *pairs, uint64_t *tmp, uint64_t n, int bits) {
+  const int ndigit = (bits + 7) / 8;
+  const int nt = omp_get_max_threads();
+  uint64_t *hist = malloc((size_t)nt * RADIX * sizeof(*hist));
+  if (!hist) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  uint64_t *src = pairs, *dst = tmp;
+  for (int pass = 0; pass < 2 * ndigit; ++pass) {
+    const int field = pass < ndigit; /* j, then i */
+    const int shift = 8 * (pass % ndigit);
+    int skip = 0;
+    OMP(parallel num_threads(nt)) {
+      const int t = omp_get_thread_num(), T = omp_get_num_threads();
+      const uint64_t lo = n * t / T, hi = n * (t + 1) / T;
+      uint64_t *h = hist + (size_t)RADIX * t;
+      memset(h, 0, RADIX * sizeof(*h));
+      for (uint64_t k = lo; k < hi; ++k)
+        ++h[(src[2 * k + field] >> shift) & (RADIX - 1)];
+      OMP(barrier)
+      OMP(single) {
+        /* Exclusive prefix, digit-major, so each thread's pairs of one
+           digit land after the lower threads'. */
+        uint64_t sum = 0;
+        for (int d = 0; d < RADIX; ++d) {
+          uint64_t dsum = 0;
+          for (int u = 0; u < T; ++u) {
+            const uint64_t c = hist[(size_t)RADIX * u + d];
+            hist[(size_t)RADIX * u + d] = sum;
+            sum += c;
+            dsum += c;
+          }
+          if (dsum == n) skip = 1;
+        }
+      }
+      if (!skip)
+        for (uint64_t k = lo; k < hi; ++k) {
+          const uint64_t pos =
+              h[(src[2 * k + field] >> shift) & (RADIX - 1)]++;
+          dst[2 * pos] = src[2 * k];
+          dst[2 * pos + 1] = src[2 * k + 1];
+        }
+    }
+    if (!skip) {
+      uint64_t *swap = src;
+      src = dst;
+      dst = swap;
+    }
+  }
+  if (src != pairs) memcpy(pairs, src, 2 * n * sizeof(*pairs));
+  free(hist);
+  return 0;
+}
+
+uint64_t elsort_unique(uint64_t *pairs, uint64_t n) {
+  uint64_t out = 0;
+  for (uint64_t k = 0; k < n; ++k) {
+    const uint64_t i = pairs[2 * k], j = pairs[2 * k + 1];
+    if (i == j) continue;
+    if (out && pairs[2 * out - 2] == i && pairs[2 * out - 1] == j) continue;
+    pairs[2 * out] = i;
+    pairs[2 * out + 1] = j;
+    ++out;
+  }
+  return out;
+}
+
+uint64_t elsort_symmetrize(uint64_t *pairs, uint64_t n) {
+  uint64_t m = 0;
+  for (uint64_t k = 0; k < n; ++k)
+    if (pairs[2 * k] != pairs[2 * k + 1]) {
+      pairs[2 * m] = pairs[2 * k];
+      pairs[2 * m + 1] = pairs[2 * k + 1];
+      ++m;
+    }
+  parfor(uint64_t k = 0; k < m; ++k) {
+    pairs[2 * (m + k)] = pairs[2 * k + 1];
+    pairs[2 * (m + k) + 1] = pairs[2 * k];
+  }
+  return 2 * m;
+}
@@ -0,0 +1,22 @@
+#if !defined(ELSORT_HEADER_)
+#define ELSORT_HEADER_
+#include <stdint.h>
+
+/* Sorting edge lists held as interleaved (i, j) pairs of 64-bit ids,
+   the el64 layout.  The sort is a parallel LSD radix sort, one byte of
+   an id per pass, j's bytes before i's, so pairs come out ordered by
+   (i, j).  Only the low bits of each id are looked at, and passes in
+   which every pair has the same byte are skipped, so a bucket of one
+   range of i costs little more than sorting j.  Functions return 0 on
+   success and -1 with errno set otherwise. */
+
+/* Sort n pairs, with tmp (also 2 * n words) as scratch. */
+int elsort_pairs (uint64_t *pairs, uint64_t *tmp, uint64_t n, int bits);
+/* Drop repeated pairs and self-loops from sorted pairs; returns how
+   many are left. */
+uint64_t elsort_unique (uint64_t *pairs, uint64_t n);
+/* Drop self-loops and append (j, i) for each remaining (i, j); pairs
+   must have room for 2 * n.  Returns the new count. */
+uint64_t elsort_symmetrize (uint64_t *pairs, uint64_t n);
+
+#endif /* ELSORT_HEADER_ */
@@ -0,0 +1,261 @@
+/* -*- C -*- */
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "compat.h"
+#include "gen-bench-cmdline.h"
+#include "generator.h"
+#include "globals.h"
+#include "hooks.h"
+#include "prng.h"
+
+/* Times the edge generator alone, with nothing downstream of it: no
+   GraphBLAS, no conversion, no file.  For each scale and thread count,
+   each kernel generates the list one chunk-sized call at a time into
+   buffers reused across calls, and one "Generator throughput" record
+   gives the fastest of --repeat runs.  Then one "Generator stage"
+   record per stage of make_edge_endpoints: the index permutation, the
+   counter-based hashing of the uniform draws, the R-MAT dart tossing,
+   and the vertex scramble. */
+
+int verbose = 0;
+
+struct gengetopt_args_info args;
+
+#define MAX_KERNELS 8
+
+enum kernel { KERNEL_SOA = 0, KERNEL_AOS, KERNEL_ENDPOINTS };
+static const char *kernel_name[] = {"edge_list_64", "edge_list_aos_64",
+                                    "edge_list_pairs_64"};
+
+enum stage {
+  STAGE_PERMUTE = 0,
+  STAGE_HASH,
+  STAGE_TOSS,
+  STAGE_SCRAMBLE,
+  NSTAGES
+};
+static const char *stage_name[] = {"index permutation", "counter hashing",
+                                   "dart tossing", "scramble"};
+
+static double wall_ms(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return 1.0e3 * t.tv_sec + 1.0e-6 * t.tv_nsec;
+}
+
+static enum kernel kernel_parse(const char *str) {
+  if (!strcmp(str, "soa")) return KERNEL_SOA;
+  if (!strcmp(str, "aos")) return KERNEL_AOS;
+  if (!strcmp(str, "endpoints")) return KERNEL_ENDPOINTS;
+  DIE("Unknown kernel: %s\n", str);
+}
+
+struct buffers {
+  int64_t *i, *j, *el;
+  uint64_t *w;
+};
+
+/* Edges 0 to ne - 1, chunk at a time.  The kernels write where their
+   callers do: edge_list_64 into the timer's I, J, V arrays,
+   edge_list_aos_64 into el-generator's (i, j, w) triples, and
+   edge_list_pairs_64 into its (i, j) pairs. */
+static void run_kernel(enum kernel kern, const struct buffers *buf,
+                       int64_t ne, int64_t chunk) {
+  for (int64_t b = 0; b < ne; b += chunk) {
+    const int64_t len = ne - b < chunk ? ne - b : chunk;
+    switch (kern) {
+      case KERNEL_SOA:
+        edge_list_64(buf->i, buf->j, buf->w, b, len, NULL);
+        break;
+      case KERNEL_AOS:
+        edge_list_aos_64(buf->el, b, len, NULL);
+        break;
+      case KERNEL_ENDPOINTS:
+        edge_list_pairs_64(buf->el, b, len, NULL);
+        break;
+    }
+  }
+}
+
+static volatile int64_t stage_sink;
+
+/* make_edge_endpoints for edges 0 to ne - 1, stopping after stage
+   last, and a value that depends on every edge so that nothing is
+   optimized away.  All edges take the R-MAT path, tree edges included;
+   those are a fraction 1 / EF of the list. */
+static int64_t run_stages(enum stage last, int64_t ne) {
+  const int big = SCALE >= SCALE_BIG_THRESH;
+  int64_t sink = 0;
+  OMP(parallel for reduction(^ : sink))
+  for (int64_t t = 0; t < ne; ++t) {
+    const int64_t k = big ? loc_to_idx_big(t) : loc_to_idx_small(t);
+    if (last == STAGE_PERMUTE) {
+      sink ^= k;
+      continue;
+    }
+    float rnd[2 * SCALE_MAX];
+    random_edgevals(rnd, k);
+    if (last == STAGE_HASH) {
+      uint32_t bits;
+      memcpy(&bits, &rnd[2 * SCALE - 1], sizeof(bits));
+      sink ^= bits;
+      continue;
+    }
+    struct i64_pair v = toss_darts(rnd);
+    if (last == STAGE_SCRAMBLE) {
+      v.v1 = scramble(v.v1);
+      v.v2 = scramble(v.v2);
+    }
+    sink ^= v.v1 ^ (v.v2 << 1);
+  }
+  return sink;
+}
+
+static void time_kernels(const struct buffers *buf, int64_t ne, int threads,
+                         const long *chunks, int n_chunks,
+                         const enum kernel *kernels, int n_kernels) {
+  for (int c = 0; c < n_chunks; ++c) {
+    for (int k = 0; k < n_kernels; ++k) {
+      double best = -1;
+      for (int r = 0; r < args.repeat_arg; ++r) {
+        const double t0 = wall_ms();
+        run_kernel(kernels[k], buf, ne, chunks[c]);
+        const double t = wall_ms() - t0;
+        if (best < 0 || t < best) best = t;
+      }
+      const double eps = best > 0 ? ne / (1.0e-3 * best) : 0;
+      hooks_set_attr_i64("scale", SCALE);
+      hooks_set_attr_i64("edgefactor", EF);
+      hooks_set_attr_str("kernel", kernel_name[kernels[k]]);
+      hooks_set_attr_i64("chunk_size", chunks[c]);
+      hooks_set_attr_i64("threads", threads);
+      hooks_set_attr_i64("edges", ne);
+      hooks_set_attr_f64("best_wall_ms", best);
+      hooks_set_attr_f64("edges_per_s", eps);
+      hooks_set_attr_f64("ns_per_edge", 1.0e6 * best / ne);
+      hooks_region_begin("Generator throughput");
+      hooks_region_end();
+      VERBOSE_PRINT("  %2d threads, chunk %8ld, %-20s %8.3f Medges/s\n",
+                    threads, chunks[c], kernel_name[kernels[k]],
+                    1.0e-6 * eps);
+    }
+  }
+}
+
+/* Each stage's time is the difference between running the stages up to
+   it and up to the one before. */
+static void time_stages(int64_t ne, int threads) {
+  double cum[NSTAGES];
+  int64_t sink = 0;
+  for (int s = 0; s < NSTAGES; ++s) {
+    cum[s] = -1;
+    for (int r = 0; r < args.repeat_arg; ++r) {
+      const double t0 = wall_ms();
+      sink ^= run_stages(s, ne);
+      const double t = wall_ms() - t0;
+      if (cum[s] < 0 || t < cum[s]) cum[s] = t;
+    }
+  }
+  stage_sink = sink;
+
+  for (int s = 0; s < NSTAGES; ++s) {
+    double t = s ? cum[s] - cum[s - 1] : cum[s];
+    if (t < 0) t = 0;
+    hooks_set_attr_i64("scale", SCALE);
+    hooks_set_attr_i64("edgefactor", EF);
+    hooks_set_attr_str("stage", stage_name[s]);
+    hooks_set_attr_i64("threads", threads);
+    hooks_set_attr_i64("edges", ne);
+    hooks_set_attr_f64("best_wall_ms", t);
+    hooks_set_attr_f64("edges_per_s", t > 0 ? ne / (1.0e-3 * t) : 0);
+    hooks_set_attr_f64("ns_per_edge", 1.0e6 * t / ne);
+    hooks_set_attr_f64("fraction",
+                       cum[NSTAGES - 1] > 0 ? t / cum[NSTAGES - 1] : 0);
+    hooks_region_begin("Generator stage");
+    hooks_region_end();
+    VERBOSE_PRINT("  %2d threads, %-20s %8.2f ns/edge\n", threads,
+                  stage_name[s], 1.0e6 * t / ne);
+  }
+}
+
+int main(int argc, char **argv) {
+  if (0 != cmdline_parser(argc, argv, &args)) exit(1);
+  if (NULL != getenv("VERBOSE")) {
+    long lvl = strtol(getenv("VERBOSE"), NULL, 10);
+    if (lvl > 1) verbose = lvl;
+  }
+  if (args.verbose_given) verbose = args.verbose_arg;
+
+  int n_scales, n_chunks, n_threads = 1, n_kernels = 0;
+  long *scales = parse_long_list(args.scales_arg, "scale", &n_scales);
+  long *chunks = parse_long_list(args.chunk_sizes_arg, "chunk size", &n_chunks);
+  long *threads;
+  if (args.threads_given)
+    threads = parse_long_list(args.threads_arg, "thread count", &n_threads);
+  else {
+    threads = malloc(sizeof(*threads));
+    if (!threads) DIE_PERROR("Cannot malloc thread count");
+    threads[0] = omp_get_max_threads();
+  }
+  enum kernel kernels[MAX_KERNELS];
+  char *saveptr = NULL;
+  for (char *tok = strtok_r(args.kernels_arg, " ,\n", &saveptr); tok;
+       tok = strtok_r(NULL, " ,\n", &saveptr)) {
+    if (n_kernels == MAX_KERNELS) DIE("Too many kernels\n");
+    kernels[n_kernels++] = kernel_parse(tok);
+  }
+  if (!n_kernels && args.no_stages_flag) DIE("Nothing to time\n");
+  if (args.repeat_arg <= 0) DIE("Invalid repeat count: %d\n", args.repeat_arg);
+  if (args.edges_arg < 0) DIE("Invalid edge count: %ld\n", args.edges_arg);
+  long max_chunk = 0;
+  for (int c = 0; c < n_chunks; ++c)
+    if (chunks[c] > max_chunk) max_chunk = chunks[c];
+
+  for (int s = 0; s < n_scales; ++s) {
+    if (scales[s] > SCALE_MAX) DIE("Scale %ld is too large\n", scales[s]);
+    init_globals(scales[s], args.edgefactor_arg, 255,
+                 1,  // unused
+                 args.A_arg, args.B_arg, args.noisefact_arg, 1);
+    const int64_t ne =
+        args.edges_arg && args.edges_arg < NE ? args.edges_arg : NE;
+    const int64_t cap = max_chunk < ne ? max_chunk : ne;
+
+    // Touched before timing, so no run pays the page faults.
+    struct buffers buf;
+    buf.i = malloc(cap * sizeof(*buf.i));
+    buf.j = malloc(cap * sizeof(*buf.j));
+    buf.w = malloc(cap * sizeof(*buf.w));
+    buf.el = malloc(3 * cap * sizeof(*buf.el));
+    if (!buf.i || !buf.j || !buf.w || !buf.el)
+      DIE_PERROR("Cannot malloc %" PRId64 "-edge buffers", cap);
+    parfor(int64_t t = 0; t < cap; ++t) {
+      buf.i[t] = buf.j[t] = 0;
+      buf.w[t] = 0;
+      buf.el[3 * t] = buf.el[3 * t + 1] = buf.el[3 * t + 2] = 0;
+    }
+
+    VERBOSE_PRINT("Scale %ld: %" PRId64 " edges\n", scales[s], ne);
+    for (int t = 0; t < n_threads; ++t) {
+      omp_set_num_threads(threads[t]);
+      time_kernels(&buf, ne, threads[t], chunks, n_chunks, kernels,
+                   n_kernels);
+      if (!args.no_stages_flag) time_stages(ne, threads[t]);
+    }
+
+    free(buf.el);
+    free(buf.w);
+    free(buf.j);
+    free(buf.i);
+  }
+
+  free(threads);
+  free(chunks);
+  free(scales);
+  cmdline_parser_free(&args);
+  return 0;
+}
@@ -54,10 +54,6 @@ int64_t loc_to_idx_small(const int64_t k) {
   return b;
 }
 
-struct i64_pair {
-  int64_t v1, v2;
-};
-
 void edge_list(int64_t* restrict i, int64_t* restrict j, uint8_t* restrict w,
                const int64_t ne_begin, const int64_t ne_len) {
   assert(SCALE);
@@ -78,13 +74,26 @@ void edge_list(int64_t* restrict i, int64_t* restrict j, uint8_t* restrict w,
   }
 }
 
+static inline void fingerprint_edge(uint64_t* restrict m, uint64_t* restrict o,
+                                    const int64_t k, const uint64_t i,
+                                    const uint64_t j) {
+  const uint64_t h = mix64(mix64(i) ^ j);
+  *m += h;
+  *o += mix64(h ^ mix64(~(uint64_t)k));
+}
+
+/* The generators below hash each edge into fp, if not NULL, in the loop
+   that makes it, while its endpoints are still in registers. */
+
 void edge_list_64(int64_t* restrict i, int64_t* restrict j,
                   uint64_t* restrict w, const int64_t ne_begin,
-                  const int64_t ne_len) {
+                  const int64_t ne_len, struct edge_fingerprint* fp) {
   assert(SCALE);
+  uint64_t m = 0, o = 0;
 
   if (SCALE < SCALE_BIG_THRESH) {
-    parfor(int64_t t = 0; t < ne_len; ++t) {
+    OMP(parallel for reduction(+ : m, o))
+    for (int64_t t = 0; t < ne_len; ++t) {
       const int64_t kp = ne_begin + t;
       const int64_t k = loc_to_idx_small(kp);
       uint8_t w_scalar;
@@ -92,9 +101,11 @@ void edge_list_64(int64_t* restrict i, int64_t* restrict j,
       assert(i[t] < NV);
       assert(j[t] < NV);
       w[t] = w_scalar;
+      if (fp) fingerprint_edge(&m, &o, kp, i[t], j[t]);
     }
   } else {
-    parfor(int64_t t = 0; t < ne_len; ++t) {
+    OMP(parallel for reduction(+ : m, o))
+    for (int64_t t = 0; t < ne_len; ++t) {
       const int64_t kp = ne_begin + t;
       const int64_t k = loc_to_idx_big(kp);
       uint8_t w_scalar;
@@ -102,8 +113,13 @@ void edge_list_64(int64_t* restrict i, int64_t* restrict j,
       assert(i[t] < NV);
       assert(j[t] < NV);
       w[t] = w_scalar;
+      if (fp) fingerprint_edge(&m, &o, kp, i[t], j[t]);
     }
   }
+  if (fp) {
+    fp->multiset += m;
+    fp->ordered += o;
+  }
 }
 
 #define elI(k) el[3 * (k)]
@@ -111,11 +127,13 @@ void edge_list_64(int64_t* restrict i, int64_t* restrict j,
 #define elV(k) el[2 + 3 * (k)]
 
 void edge_list_aos_64(int64_t* restrict el, const int64_t ne_begin,
-                      const int64_t ne_len) {
+                      const int64_t ne_len, struct edge_fingerprint* fp) {
   assert(SCALE);
+  uint64_t m = 0, o = 0;
 
   if (SCALE < SCALE_BIG_THRESH) {
-    parfor(int64_t t = 0; t < ne_len; ++t) {
+    OMP(parallel for reduction(+ : m, o))
+    for (int64_t t = 0; t < ne_len; ++t) {
       const int64_t kp = ne_begin + t;
       const int64_t k = loc_to_idx_small(kp);
       uint8_t w_scalar;
@@ -123,9 +141,11 @@ void edge_list_aos_64(int64_t* restrict el, const int64_t ne_begin,
       assert(elI(t) < NV);
       assert(elJ(t) < NV);
       elV(t) = w_scalar;
+      if (fp) fingerprint_edge(&m, &o, kp, elI(t), elJ(t));
     }
   } else {
-    parfor(int64_t t = 0; t < ne_len; ++t) {
+    OMP(parallel for reduction(+ : m, o))
+    for (int64_t t = 0; t < ne_len; ++t) {
       const int64_t kp = ne_begin + t;
       const int64_t k = loc_to_idx_big(kp);
       uint8_t w_scalar;
@@ -133,8 +153,99 @@ void edge_list_aos_64(int64_t* restrict el, const int64_t ne_begin,
       assert(elI(t) < NV);
       assert(elJ(t) < NV);
       elV(t) = w_scalar;
+      if (fp) fingerprint_edge(&m, &o, kp, elI(t), elJ(t));
     }
   }
+  if (fp) {
+    fp->multiset += m;
+    fp->ordered += o;
+  }
+}
+
+/* Endpoints only, as (i, j) pairs; the el64 layout, so no weight is
+   drawn or copied out. */
+void edge_list_pairs_64(int64_t* restrict el, const int64_t ne_begin,
+                        const int64_t ne_len, struct edge_fingerprint* fp) {
+  assert(SCALE);
+  uint64_t m = 0, o = 0;
+
+  if (SCALE < SCALE_BIG_THRESH) {
+    OMP(parallel for reduction(+ : m, o))
+    for (int64_t t = 0; t < ne_len; ++t) {
+      const int64_t k = loc_to_idx_small(ne_begin + t);
+      make_edge_endpoints(k, &el[2 * t], &el[1 + 2 * t]);
+      assert(el[2 * t] < NV);
+      assert(el[1 + 2 * t] < NV);
+      if (fp) fingerprint_edge(&m, &o, ne_begin + t, el[2 * t], el[1 + 2 * t]);
+    }
+  } else {
+    OMP(parallel for reduction(+ : m, o))
+    for (int64_t t = 0; t < ne_len; ++t) {
+      const int64_t k = loc_to_idx_big(ne_begin + t);
+      make_edge_endpoints(k, &el[2 * t], &el[1 + 2 * t]);
+      assert(el[2 * t] < NV);
+      assert(el[1 + 2 * t] < NV);
+      if (fp) fingerprint_edge(&m, &o, ne_begin + t, el[2 * t], el[1 + 2 * t]);
+    }
+  }
+  if (fp) {
+    fp->multiset += m;
+    fp->ordered += o;
+  }
+}
+
+/* Endpoints only, as (i, j) pairs of 32-bit vertex ids; SCALE <= 32. */
+void edge_list_aos_32(uint32_t* restrict el, const int64_t ne_begin,
+                      const int64_t ne_len, struct edge_fingerprint* fp) {
+  assert(SCALE && SCALE <= 32);
+  uint64_t m = 0, o = 0;
+
+  if (SCALE < SCALE_BIG_THRESH) {
+    OMP(parallel for reduction(+ : m, o))
+    for (int64_t t = 0; t < ne_len; ++t) {
+      const int64_t k = loc_to_idx_small(ne_begin + t);
+      int64_t i, j;
+      make_edge_endpoints(k, &i, &j);
+      el[2 * t] = i;
+      el[1 + 2 * t] = j;
+      if (fp) fingerprint_edge(&m, &o, ne_begin + t, i, j);
+    }
+  } else {
+    OMP(parallel for reduction(+ : m, o))
+    for (int64_t t = 0; t < ne_len; ++t) {
+      const int64_t k = loc_to_idx_big(ne_begin + t);
+      int64_t i, j;
+      make_edge_endpoints(k, &i, &j);
+      el[2 * t] = i;
+      el[1 + 2 * t] = j;
+      if (fp) fingerprint_edge(&m, &o, ne_begin + t, i, j);
+    }
+  }
+  if (fp) {
+    fp->multiset += m;
+    fp->ordered += o;
+  }
+}
+
+void edge_fingerprint_64(struct edge_fingerprint* fp, const int64_t* i,
+                         const int64_t* j, const int64_t s,
+                         const int64_t ne_begin, const int64_t ne_len) {
+  uint64_t m = 0, o = 0;
+  OMP(parallel for reduction(+ : m, o))
+  for (int64_t t = 0; t < ne_len; ++t)
+    fingerprint_edge(&m, &o, ne_begin + t, i[s * t], j[s * t]);
+  fp->multiset += m;
+  fp->ordered += o;
+}
+
+void edge_fingerprint_32(struct edge_fingerprint* fp, const uint32_t* el,
+                         const int64_t ne_begin, const int64_t ne_len) {
+  uint64_t m = 0, o = 0;
+  OMP(parallel for reduction(+ : m, o))
+  for (int64_t t = 0; t < ne_len; ++t)
+    fingerprint_edge(&m, &o, ne_begin + t, el[2 * t], el[1 + 2 * t]);
+  fp->multiset += m;
+  fp->ordered += o;
 }
 
 /* Replacable for system optimizations. */
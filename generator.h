@@ -7,9 +7,56 @@ void make_edge(int64_t, int64_t* restrict, int64_t* restrict,
 void make_edge_endpoints(int64_t, int64_t* restrict, int64_t* restrict);
 void edge_list(int64_t* restrict, int64_t* restrict, uint8_t* restrict,
                const int64_t, const int64_t);
+/* The splitmix64 finalizer, the hash behind edge fingerprints and
+   el-generator's checksums. */
+static inline uint64_t mix64(uint64_t x) {
+  x ^= x >> 30;
+  x *= UINT64_C(0xbf58476d1ce4e5b9);
+  x ^= x >> 27;
+  x *= UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+/* Identifies a generated edge list.  multiset sums a hash of each
+   (i, j), so it does not depend on the order of the edges; ordered
+   sums a hash of each (i, j) with its index in the list.  Sums over
+   disjoint ranges of edges add up to the sum over their union, so
+   chunks, threads and processes can each add their part. */
+struct edge_fingerprint {
+  uint64_t multiset, ordered;
+};
+
+// "multiset:ordered" in hex, and its length.
+#define EDGE_FINGERPRINT_LEN 33
+#define EDGE_FINGERPRINT_FMT "%016" PRIx64 ":%016" PRIx64
+
+/* Generate edges ne_begin to ne_begin + ne_len - 1 and, if the last
+   argument is not NULL, add them to that fingerprint as they are made. */
 void edge_list_64(int64_t* restrict, int64_t* restrict, uint64_t* restrict,
-                  const int64_t, const int64_t);
-void edge_list_aos_64(int64_t* restrict, const int64_t, const int64_t);
+                  const int64_t, const int64_t, struct edge_fingerprint*);
+void edge_list_aos_64(int64_t* restrict, const int64_t, const int64_t,
+                      struct edge_fingerprint*);
+void edge_list_pairs_64(int64_t* restrict, const int64_t, const int64_t,
+                        struct edge_fingerprint*);
+void edge_list_aos_32(uint32_t* restrict, const int64_t, const int64_t,
+                      struct edge_fingerprint*);
+
+/* Add edges already made, as for a list read back from a file: edges
+   ne_begin to ne_begin + ne_len - 1, with endpoints i[s * t] and
+   j[s * t] for t < ne_len. */
+void edge_fingerprint_64(struct edge_fingerprint*, const int64_t*,
+                         const int64_t*, const int64_t s, const int64_t,
+                         const int64_t);
+// The same from (i, j) pairs of 32-bit vertex ids.
+void edge_fingerprint_32(struct edge_fingerprint*, const uint32_t*,
+                         const int64_t, const int64_t);
+
+/* The R-MAT descent from make_edge's 2 * SCALE uniform draws, exposed
+   so gen-bench can time it apart from the draws. */
+struct i64_pair {
+  int64_t v1, v2;
+};
+struct i64_pair toss_darts(const float*);
 
 int64_t loc_to_idx_big(const int64_t kp);
 int64_t loc_to_idx_small(const int64_t k);
@@ -1,7 +1,10 @@
+#define _POSIX_C_SOURCE 200809L
 #include <assert.h>
+#include <errno.h>
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define IN_GLOBALS_C
 #include "globals.h"
@@ -132,3 +135,20 @@ void init_globals(int scale, int ef, int maxweight, int nroot, float a, float b,
   }
 #endif
 }
+
+long *parse_long_list(char *str, const char *what, int *n_out) {
+  int n = 0;
+  long *out = malloc((strlen(str) + 1) * sizeof(*out));
+  if (!out) DIE_PERROR("Cannot malloc %s", what);
+  char *saveptr = NULL;
+  for (char *tok = strtok_r(str, " ,\n", &saveptr); tok;
+       tok = strtok_r(NULL, " ,\n", &saveptr)) {
+    errno = 0;
+    const long val = strtol(tok, NULL, 10);
+    if (errno) DIE_PERROR("Error parsing %s %d", what, n + 1);
+    if (val <= 0) DIE("Invalid %s value: %ld\n", what, val);
+    out[n++] = val;
+  }
+  *n_out = n;
+  return out;
+}
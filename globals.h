@@ -62,5 +62,8 @@ extern int gen_tree;
 #endif
 
 void init_globals (int, int, int, int, float, float, float, int);
+/* Parse a space/comma-delimited list of positive integers into a
+   malloc'd array, dying on anything else.  Modifies the string. */
+long *parse_long_list (char *, const char *what, int *n_out);
 
 #endif /* GLOBALS_HEADER_ */
@@ -90,6 +90,10 @@ struct edge_list_file_header {
   //   32  : binary, 32 bits per field
   //   64  : binary, 64 bits per field
   char* format;
+  // Bytes per vertex id: 8 for el64, 4 for el32
+  size_t id_bytes = 8;
+  // wel64: a 64-bit weight follows each (src, dst)
+  bool weighted = false;
   // Number of bytes in the file header.
   // Includes the newline character
   // There is no null terminator
@@ -116,8 +120,13 @@ edge_list_file_header parse_header(std::ifstream& fs) {
   while (std::getline(header_ss, tok, ' ')) {
     if (tok == "--format") {
       std::getline(header_ss, tok, ' ');
-      if (tok != "el64") {
-        std::cerr << "The format in header is unsupported, must be el64"
+      if (tok == "el32") {
+        header.id_bytes = 4;
+      } else if (tok == "wel64") {
+        header.weighted = true;
+      } else if (tok != "el64") {
+        std::cerr << "The format in header is unsupported, must be el64, "
+                     "el32, or wel64"
                   << std::endl;
         exit(EXIT_FAILURE);
       }
@@ -159,6 +168,17 @@ edge_list_file_header parse_header(std::ifstream& fs) {
   return header;
 }
 
+// Read one vertex id of the file's width
+bool read_id(std::ifstream& fs, size_t id_bytes, size_t& id) {
+  if (id_bytes == 4) {
+    uint32_t id32;
+    if (!fs.read(reinterpret_cast<char*>(&id32), sizeof(id32))) return false;
+    id = id32;
+    return true;
+  }
+  return static_cast<bool>(fs.read(reinterpret_cast<char*>(&id), sizeof(id)));
+}
+
 void verify_graph(std::ifstream& fs, edge_list_file_header const& header,
                   std::string output) {
   //
@@ -185,10 +205,13 @@ void verify_graph(std::ifstream& fs, edge_list_file_header const& header,
   //
   // TODO use mmap for this so we can do it in parallel (and with less memory)
   while (fs) {
-    if (!fs.read(reinterpret_cast<char*>(&src), sizeof(long))) {
+    if (!read_id(fs, header.id_bytes, src)) {
+      break;
+    }
+    if (!read_id(fs, header.id_bytes, dst)) {
       break;
     }
-    if (!fs.read(reinterpret_cast<char*>(&dst), sizeof(long))) {
+    if (header.weighted && !fs.ignore(sizeof(uint64_t))) {
       break;
     }
     // std::cout << n_edges_read << " " << src << " " << dst << std::endl;
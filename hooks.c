@@ -2,7 +2,27 @@
  \date February 20, 2021
  \author Eric Hein and Jason Riedy (made generic)
  \brief Source file for hooks for timing and other region measurements
+
+ Regions may nest.  Attributes set with hooks_set_attr_* are held
+ until the next hooks_region_begin (which claims them for the new
+ region) or hooks_region_end (which adds them to the innermost open
+ region), so the usual "set attrs, begin, set more attrs, end" pattern
+ behaves as it always has.
+
+ Each finished region is written to every configured sink:
+   HOOKS_FILENAME        one JSON object per line (default: stdout)
+   HOOKS_CSV_FILENAME    long-form CSV, one row per field
+   HOOKS_TRACE_FILENAME  Chrome trace-event JSON (chrome://tracing, Perfetto)
+ If only the CSV or trace sink is set, the JSON lines are not echoed
+ to stdout.
+
+ Setting HOOKS_SAMPLE_MS starts a background thread that, while any
+ region is open, samples wall time, resident set size and process CPU
+ utilization into a preallocated ring (HOOKS_SAMPLE_CAPACITY entries,
+ default 4096).  Each region's record carries the samples taken while
+ it was open.  With HOOKS_SAMPLE_MS unset no thread is started.
  */
+#define _POSIX_C_SOURCE 200809L
 #include "hooks.h"
 #include <stdio.h>
 #include <string.h>
@@ -11,24 +31,343 @@
 #include <stdarg.h>
 #include <assert.h>
 #include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+// One key/value pair.  Values are kept pre-formatted; is_str says
+// whether they need quoting and escaping on output.
+typedef struct hooks_field {
+    char *key;
+    char *val;
+    bool is_str;
+} hooks_field;
+
+typedef struct hooks_fields {
+    hooks_field *f;
+    size_t n, cap;
+} hooks_fields;
+
+typedef struct hooks_frame {
+    char *name;
+    int64_t id, parent_id;
+    int depth;
+    clock_t ticks_begin;
+    double wall_begin_us;
+    uint64_t sample_begin;
+    hooks_fields fields;
+} hooks_frame;
+
+typedef struct hooks_sample {
+    double t_us;
+    double rss_mib;
+    double cpu_util;
+} hooks_sample;
+
+// Background sampler state.  The ring is written only by the sampler
+// thread; readers take the lock while copying out a region's window.
+typedef struct hooks_sampler {
+    bool enabled;
+    long interval_us;
+    size_t cap;
+    hooks_sample *ring;
+    uint64_t head;            // total samples ever written
+    uint64_t trace_emitted;   // samples already written as trace counters
+    atomic_int nactive;       // open regions; sampler idles at zero
+    int statm_fd;
+    pthread_mutex_t lock;
+    pthread_t thread;
+} hooks_sampler;
+
+typedef struct hooks_sinks {
+    bool init;
+    FILE *jsonl;
+    FILE *csv;
+    FILE *trace;
+    bool trace_first;
+} hooks_sinks;
+
+static hooks_sinks sinks = {};
+
+// Attributes waiting for a region to claim them
+static hooks_fields pending = {};
+
+// Stack of open regions
+static hooks_frame *stack = NULL;
+static size_t stack_n = 0, stack_cap = 0;
+static int64_t next_region_id = 0;
+
+static hooks_sampler sampler = { .lock = PTHREAD_MUTEX_INITIALIZER, .statm_fd = -1 };
+
+static void *
+hooks_xrealloc (void *p, size_t sz)
+{
+    void *out = realloc (p, sz);
+    if (!out) {
+        perror ("hooks: out of memory");
+        abort ();
+    }
+    return out;
+}
+
+static char *
+hooks_xstrdup (const char *s)
+{
+    size_t len = strlen (s) + 1;
+    char *out = hooks_xrealloc (NULL, len);
+    memcpy (out, s, len);
+    return out;
+}
+
+// vsnprintf into a freshly allocated, exactly sized string
+static char *
+hooks_vasprintf (const char *fmt, va_list args)
+{
+    va_list args2;
+    va_copy (args2, args);
+    int len = vsnprintf (NULL, 0, fmt, args);
+    assert (len >= 0);
+    char *out = hooks_xrealloc (NULL, len + 1);
+    vsnprintf (out, len + 1, fmt, args2);
+    va_end (args2);
+    return out;
+}
+
+static void
+hooks_fields_push (hooks_fields *fs, const char *key, char *val, bool is_str)
+{
+    if (fs->n == fs->cap) {
+        fs->cap = fs->cap ? 2 * fs->cap : 16;
+        fs->f = hooks_xrealloc (fs->f, fs->cap * sizeof (*fs->f));
+    }
+    fs->f[fs->n].key = hooks_xstrdup (key);
+    fs->f[fs->n].val = val;
+    fs->f[fs->n].is_str = is_str;
+    ++fs->n;
+}
+
+// Move all of src onto the end of dst, leaving src empty
+static void
+hooks_fields_splice (hooks_fields *dst, hooks_fields *src)
+{
+    for (size_t k = 0; k < src->n; ++k) {
+        hooks_fields_push (dst, src->f[k].key, src->f[k].val, src->f[k].is_str);
+        free (src->f[k].key);
+    }
+    src->n = 0;
+}
+
+static void
+hooks_fields_clear (hooks_fields *fs)
+{
+    for (size_t k = 0; k < fs->n; ++k) {
+        free (fs->f[k].key);
+        free (fs->f[k].val);
+    }
+    free (fs->f);
+    memset (fs, 0, sizeof (*fs));
+}
+
+static void
+hooks_add_field (bool is_str, const char *key, const char *fmt, ...)
+{
+    va_list args;
+    va_start (args, fmt);
+    hooks_fields_push (&pending, key, hooks_vasprintf (fmt, args), is_str);
+    va_end (args);
+}
+
+// Output helpers
+
+static void
+json_put_str (FILE *fp, const char *s)
+{
+    fputc ('"', fp);
+    for (; *s; ++s) {
+        unsigned char c = *s;
+        switch (c) {
+        case '"': fputs ("\\\"", fp); break;
+        case '\\': fputs ("\\\\", fp); break;
+        case '\n': fputs ("\\n", fp); break;
+        case '\r': fputs ("\\r", fp); break;
+        case '\t': fputs ("\\t", fp); break;
+        case '\b': fputs ("\\b", fp); break;
+        case '\f': fputs ("\\f", fp); break;
+        default:
+            if (c < 0x20) fprintf (fp, "\\u%04x", c);
+            else fputc (c, fp);
+        }
+    }
+    fputc ('"', fp);
+}
+
+static void
+json_put_fields (FILE *fp, const hooks_fields *fs, bool leading_comma)
+{
+    for (size_t k = 0; k < fs->n; ++k) {
+        if (k || leading_comma) fputc (',', fp);
+        json_put_str (fp, fs->f[k].key);
+        fputc (':', fp);
+        if (fs->f[k].is_str) json_put_str (fp, fs->f[k].val);
+        else fputs (fs->f[k].val, fp);
+    }
+}
+
+static void
+csv_put_str (FILE *fp, const char *s)
+{
+    if (!strpbrk (s, ",\"\r\n")) {
+        fputs (s, fp);
+        return;
+    }
+    fputc ('"', fp);
+    for (; *s; ++s) {
+        if (*s == '"') fputc ('"', fp);
+        fputc (*s, fp);
+    }
+    fputc ('"', fp);
+}
+
+static void
+hooks_trace_close (void)
+{
+    if (sinks.trace) {
+        fprintf (sinks.trace, "\n]}\n");
+        fclose (sinks.trace);
+        sinks.trace = NULL;
+    }
+}
+
+static FILE *
+hooks_open (const char *filename, const char *mode)
+{
+    FILE *fp = fopen (filename, mode);
+    if (!fp) {
+        fprintf (stderr, "hooks: cannot open \"%s\": ", filename);
+        perror ("");
+        abort ();
+    }
+    return fp;
+}
+
+// Singleton controlling hooks output files
+static void
+hooks_init_sinks (void)
+{
+    if (sinks.init) return;
+    sinks.init = true;
+
+    const char *csv = getenv ("HOOKS_CSV_FILENAME");
+    if (csv) {
+        sinks.csv = hooks_open (csv, "a");
+        // Appending to an existing file: header is already there.
+        fseek (sinks.csv, 0, SEEK_END);
+        if (ftell (sinks.csv) == 0)
+            fprintf (sinks.csv, "region_id,parent_id,depth,region_name,key,value\n");
+    }
+
+    const char *trace = getenv ("HOOKS_TRACE_FILENAME");
+    if (trace) {
+        // A trace file is a single JSON document, so it cannot be appended.
+        sinks.trace = hooks_open (trace, "w");
+        fprintf (sinks.trace, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        sinks.trace_first = true;
+        atexit (hooks_trace_close);
+    }
+
+    const char *filename = getenv ("HOOKS_FILENAME");
+    if (filename)
+        sinks.jsonl = hooks_open (filename, "a");
+    else if (!csv && !trace)
+        // HOOKS_FILENAME unset, defaulting to stdout
+        sinks.jsonl = stdout;
+}
 
-// Singleton controlling hooks output file
 FILE *
 hooks_output_file()
 {
-    static FILE* fp = NULL;
-    if (fp == NULL) {
-        const char* filename = getenv("HOOKS_FILENAME");
-        if (filename)
-        {
-            fp = fopen(filename, "a");
-            assert(fp);
-        } else {
-            // HOOKS_FILENAME unset, defaulting to stdout
-            fp = stdout;
+    hooks_init_sinks ();
+    return sinks.jsonl;
+}
+
+static void
+hooks_emit (const hooks_frame *fr, double time_ms, double wall_end_us, clock_t ticks,
+            const hooks_sample *smp, size_t nsmp, uint64_t smp_first, uint64_t ndropped)
+{
+    hooks_init_sinks ();
+
+    if (sinks.jsonl) {
+        FILE *fp = sinks.jsonl;
+        fputc ('{', fp);
+        json_put_fields (fp, &fr->fields, false);
+        fprintf (fp, ",\"region_id\":%ld,\"parent_id\":%ld,\"depth\":%d",
+                 (long)fr->id, (long)fr->parent_id, fr->depth);
+        fprintf (fp, ",\"time_ms\":%3.2f,\"ticks\":%li,\"wall_ms\":%3.3f",
+                 time_ms, (long)ticks, (wall_end_us - fr->wall_begin_us) / 1000.0);
+        if (sampler.enabled) {
+            fprintf (fp, ",\"samples_dropped\":%lu,\"samples\":{\"t_ms\":[", (unsigned long)ndropped);
+            for (size_t k = 0; k < nsmp; ++k)
+                fprintf (fp, "%s%.3f", k ? "," : "", (smp[k].t_us - fr->wall_begin_us) / 1000.0);
+            fprintf (fp, "],\"rss_mib\":[");
+            for (size_t k = 0; k < nsmp; ++k)
+                fprintf (fp, "%s%.1f", k ? "," : "", smp[k].rss_mib);
+            fprintf (fp, "],\"cpu_util\":[");
+            for (size_t k = 0; k < nsmp; ++k)
+                fprintf (fp, "%s%.2f", k ? "," : "", smp[k].cpu_util);
+            fprintf (fp, "]}");
         }
+        fprintf (fp, "}\n");
+        fflush (fp);
+    }
+
+    if (sinks.csv) {
+        FILE *fp = sinks.csv;
+        for (size_t k = 0; k < fr->fields.n; ++k) {
+            fprintf (fp, "%ld,%ld,%d,", (long)fr->id, (long)fr->parent_id, fr->depth);
+            csv_put_str (fp, fr->name);
+            fputc (',', fp);
+            csv_put_str (fp, fr->fields.f[k].key);
+            fputc (',', fp);
+            csv_put_str (fp, fr->fields.f[k].val);
+            fputc ('\n', fp);
+        }
+        fprintf (fp, "%ld,%ld,%d,", (long)fr->id, (long)fr->parent_id, fr->depth);
+        csv_put_str (fp, fr->name);
+        fprintf (fp, ",time_ms,%3.2f\n", time_ms);
+        for (size_t k = 0; k < nsmp; ++k) {
+            fprintf (fp, "%ld,%ld,%d,", (long)fr->id, (long)fr->parent_id, fr->depth);
+            csv_put_str (fp, fr->name);
+            fprintf (fp, ",sample,%.3f;%.1f;%.2f\n",
+                     (smp[k].t_us - fr->wall_begin_us) / 1000.0, smp[k].rss_mib, smp[k].cpu_util);
+        }
+        fflush (fp);
+    }
+
+    if (sinks.trace) {
+        FILE *fp = sinks.trace;
+        if (!sinks.trace_first) fprintf (fp, ",\n");
+        sinks.trace_first = false;
+        // Complete ("X") events nest by time on a single track.
+        fprintf (fp, "{\"name\":");
+        json_put_str (fp, fr->name);
+        fprintf (fp, ",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{",
+                 fr->wall_begin_us, wall_end_us - fr->wall_begin_us);
+        json_put_fields (fp, &fr->fields, false);
+        fprintf (fp, "%s\"region_id\":%ld,\"parent_id\":%ld,\"time_ms\":%3.2f}}",
+                 fr->fields.n ? "," : "", (long)fr->id, (long)fr->parent_id, time_ms);
+        // Counter tracks; nested regions share samples, so emit each once.
+        for (size_t k = 0; k < nsmp; ++k) {
+            if (smp_first + k < sampler.trace_emitted) continue;
+            fprintf (fp, ",\n{\"name\":\"rss_mib\",\"ph\":\"C\",\"pid\":0,\"ts\":%.3f,\"args\":{\"rss_mib\":%.1f}}",
+                     smp[k].t_us, smp[k].rss_mib);
+            fprintf (fp, ",\n{\"name\":\"cpu_util\",\"ph\":\"C\",\"pid\":0,\"ts\":%.3f,\"args\":{\"cpu_util\":%.2f}}",
+                     smp[k].t_us, smp[k].cpu_util);
+        }
+        if (smp_first + nsmp > sampler.trace_emitted)
+            sampler.trace_emitted = smp_first + nsmp;
+        fflush (fp);
     }
-    return fp;
 }
 
 // Singleton controlling initialization of core_clk_mhz
@@ -36,6 +375,95 @@ static double get_core_clk_mhz() {
      return CLOCKS_PER_SEC / 1.0e6;
 }
 
+static double
+wall_us (void)
+{
+    static struct timespec t0 = {0, 0};
+    struct timespec t;
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    if (t0.tv_sec == 0 && t0.tv_nsec == 0) t0 = t;
+    return 1.0e6 * (t.tv_sec - t0.tv_sec) + 1.0e-3 * (t.tv_nsec - t0.tv_nsec);
+}
+
+static double
+cpu_us (void)
+{
+    struct timespec t;
+    clock_gettime (CLOCK_PROCESS_CPUTIME_ID, &t);
+    return 1.0e6 * t.tv_sec + 1.0e-3 * t.tv_nsec;
+}
+
+static double
+rss_mib (void)
+{
+    static long pagesz = 0;
+    char buf[128];
+    if (!pagesz) pagesz = sysconf (_SC_PAGESIZE);
+    ssize_t len = pread (sampler.statm_fd, buf, sizeof (buf) - 1, 0);
+    if (len <= 0) return 0.0;
+    buf[len] = '\0';
+    unsigned long size, resident;
+    if (sscanf (buf, "%lu %lu", &size, &resident) != 2) return 0.0;
+    return (double)resident * pagesz / (1 << 20);
+}
+
+static void *
+hooks_sampler_main (void *arg)
+{
+    (void)arg;
+    double last_wall = wall_us (), last_cpu = cpu_us ();
+    const struct timespec nap = { sampler.interval_us / 1000000,
+                                  1000 * (sampler.interval_us % 1000000) };
+    for (;;) {
+        nanosleep (&nap, NULL);
+        const double w = wall_us (), c = cpu_us ();
+        if (atomic_load_explicit (&sampler.nactive, memory_order_relaxed) > 0) {
+            hooks_sample smp = { w, rss_mib (), (c - last_cpu) / (w - last_wall) };
+            pthread_mutex_lock (&sampler.lock);
+            sampler.ring[sampler.head % sampler.cap] = smp;
+            ++sampler.head;
+            pthread_mutex_unlock (&sampler.lock);
+        }
+        last_wall = w;
+        last_cpu = c;
+    }
+    return NULL;
+}
+
+// Start the sampler on first use if HOOKS_SAMPLE_MS asks for it
+static void
+hooks_sampler_init (void)
+{
+    static bool init = false;
+    if (init) return;
+    init = true;
+
+    const char *ms = getenv ("HOOKS_SAMPLE_MS");
+    if (!ms) return;
+    double interval_ms = strtod (ms, NULL);
+    if (interval_ms <= 0) return;
+
+    const char *cap = getenv ("HOOKS_SAMPLE_CAPACITY");
+    sampler.cap = cap ? strtoul (cap, NULL, 10) : 4096;
+    if (!sampler.cap) sampler.cap = 4096;
+    sampler.interval_us = (long)(1000 * interval_ms);
+    if (sampler.interval_us < 1) sampler.interval_us = 1;
+    sampler.ring = hooks_xrealloc (NULL, sampler.cap * sizeof (*sampler.ring));
+    // Touch the ring now so sampling never faults in new pages.
+    memset (sampler.ring, 0, sampler.cap * sizeof (*sampler.ring));
+    sampler.statm_fd = open ("/proc/self/statm", O_RDONLY);
+
+    wall_us (); // pin the time origin before the thread reads it
+    if (pthread_create (&sampler.thread, NULL, hooks_sampler_main, NULL)) {
+        fprintf (stderr, "hooks: cannot start sampler thread, sampling disabled\n");
+        free (sampler.ring);
+        sampler.ring = NULL;
+        return;
+    }
+    pthread_detach (sampler.thread);
+    sampler.enabled = true;
+}
+
 // The simulator can only handle one region of interest
 // This global variable controls which region will get starttiming() called
 const char* hooks_active_region = NULL;
@@ -51,79 +479,91 @@ bool region_is_active(const char* name)
     else { return (bool)!strcmp(name, hooks_active_region); }
 }
 
-// Global timer variable
-static int64_t hooks_timestamp = 0;
-
-// Stores string that will be printed at the end of this region
-#define HOOKS_STR_LEN 4096
-typedef struct hooks_data {
-    char str[HOOKS_STR_LEN];
-    size_t pos;
-} hooks_data;
-static hooks_data data = {};
-
-// Append to buffer with printf
-static void
-hooks_data_append(const char* fmt, ...)
+void hooks_region_begin(const char* name)
 {
-    va_list args;
-    va_start(args, fmt);
-    assert(data.pos < HOOKS_STR_LEN);
-    data.pos += vsprintf(data.str + data.pos, fmt, args);
-    assert(data.pos < HOOKS_STR_LEN);
-    va_end(args);
-}
+    if (stack_n == stack_cap) {
+        stack_cap = stack_cap ? 2 * stack_cap : 8;
+        stack = hooks_xrealloc (stack, stack_cap * sizeof (*stack));
+    }
+    hooks_frame *fr = &stack[stack_n];
+    memset (fr, 0, sizeof (*fr));
+    fr->name = hooks_xstrdup (name);
+    fr->id = next_region_id++;
+    fr->parent_id = stack_n ? stack[stack_n-1].id : -1;
+    fr->depth = stack_n;
+    ++stack_n;
 
-// Append JSON field to string
-static void
-hooks_add_field(const char* key, const char* fmt, ...)
-{
-    va_list args;
-    va_start(args, fmt);
+    // Claim the attributes set before this region, then add the name
+    hooks_fields_splice (&fr->fields, &pending);
+    hooks_fields_push (&fr->fields, "region_name", hooks_xstrdup (name), true);
 
-    if (strlen(data.str) == 0) {
-        // Begin JSON object
-        hooks_data_append("{");
-    } else {
-        // Comma after previous field
-        hooks_data_append(",");
+    hooks_sampler_init ();
+    if (sampler.enabled) {
+        pthread_mutex_lock (&sampler.lock);
+        fr->sample_begin = sampler.head;
+        pthread_mutex_unlock (&sampler.lock);
+        atomic_fetch_add (&sampler.nactive, 1);
     }
-    // Print key
-    hooks_data_append("\"%s\":", key);
-    // Do printf from arguments
-    assert(data.pos < HOOKS_STR_LEN);
-    data.pos += vsprintf(data.str + data.pos, fmt, args);
-    assert(data.pos < HOOKS_STR_LEN);
-    va_end(args);
-}
-
-void hooks_region_begin(const char* name)
-{
-    // Add region name to the result string
-    hooks_add_field("region_name", "\"%s\"", name);
 
     // Start the timer
-    hooks_timestamp = -clock();
+    fr->wall_begin_us = wall_us ();
+    fr->ticks_begin = clock();
 }
 
 double hooks_region_end()
 {
     // Stop the timer
-    hooks_timestamp += clock();
+    clock_t ticks_end = clock();
+    double wall_end_us = wall_us ();
 
-    // Add time elapsed to result string
-    double time_ms = (1000.0 * hooks_timestamp) / (get_core_clk_mhz()*1e6);
-    hooks_add_field("time_ms", "%3.2f", time_ms);
-    hooks_add_field("ticks", "%li", hooks_timestamp);
+    if (stack_n == 0) {
+        fprintf (stderr, "hooks: hooks_region_end without a matching begin\n");
+        hooks_fields_clear (&pending);
+        return 0.0;
+    }
+    hooks_frame *fr = &stack[--stack_n];
+    const int64_t ticks = (int64_t)(ticks_end - fr->ticks_begin);
+
+    // Attributes set while this region was innermost belong to it
+    hooks_fields_splice (&fr->fields, &pending);
+
+    // Time elapsed
+    double time_ms = (1000.0 * ticks) / (get_core_clk_mhz()*1e6);
+
+    // Copy out the samples taken while this region was open.  Older
+    // ones may have been overwritten if the ring wrapped.
+    hooks_sample *smp = NULL;
+    size_t nsmp = 0;
+    uint64_t smp_first = 0, ndropped = 0;
+    if (sampler.enabled) {
+        atomic_fetch_sub (&sampler.nactive, 1);
+        pthread_mutex_lock (&sampler.lock);
+        const uint64_t head = sampler.head;
+        smp_first = fr->sample_begin;
+        if (head - smp_first > sampler.cap) {
+            ndropped = head - smp_first - sampler.cap;
+            smp_first = head - sampler.cap;
+        }
+        nsmp = head - smp_first;
+        if (nsmp) {
+            smp = hooks_xrealloc (NULL, nsmp * sizeof (*smp));
+            for (size_t k = 0; k < nsmp; ++k)
+                smp[k] = sampler.ring[(smp_first + k) % sampler.cap];
+        }
+        pthread_mutex_unlock (&sampler.lock);
+    }
 
     // Dump results
-    fprintf(hooks_output_file(), "%s}\n", data.str); fflush(hooks_output_file());
-    memset(&data, 0, sizeof(hooks_data));
+    hooks_emit (fr, time_ms, wall_end_us, ticks, smp, nsmp, smp_first, ndropped);
+    free (smp);
+
+    hooks_fields_clear (&fr->fields);
+    free (fr->name);
 
     return time_ms;
 }
 
-void hooks_set_attr_u64(const char * key, uint64_t value) { hooks_add_field(key, "%lu", value); }
-void hooks_set_attr_i64(const char * key, int64_t value) { hooks_add_field(key, "%li", value); }
-void hooks_set_attr_f64(const char * key, double value) { hooks_add_field(key, "%f", value); }
-void hooks_set_attr_str(const char * key, const char* value) { hooks_add_field(key, "\"%s\"", value);}
+void hooks_set_attr_u64(const char * key, uint64_t value) { hooks_add_field(false, key, "%lu", value); }
+void hooks_set_attr_i64(const char * key, int64_t value) { hooks_add_field(false, key, "%li", value); }
+void hooks_set_attr_f64(const char * key, double value) { hooks_add_field(false, key, "%f", value); }
+void hooks_set_attr_str(const char * key, const char* value) { hooks_add_field(true, key, "%s", value);}
@@ -0,0 +1,171 @@
+#define _GNU_SOURCE
+#include "compat.h"
+#include "hugepage.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "globals.h"
+
+extern int verbose;
+
+/* Every allocation outside HUGEPAGE_OFF carries this header just
+   before the returned pointer, so free and realloc know how it was
+   made.  64 bytes keeps the payload cache-line aligned. */
+#define HDR_MAGIC UINT64_C(0x6875676570616765)
+enum { KIND_MALLOC = 1, KIND_MMAP };
+struct hdr {
+  uint64_t magic;
+  uint64_t kind;
+  void *base;
+  size_t maplen;
+  size_t size;
+  char pad[64 - 5 * 8];
+};
+
+static enum hugepage_mode mode = HUGEPAGE_OFF;
+
+enum hugepage_mode hugepage_mode_parse(const char *s) {
+  if (!s || !strcmp(s, "off")) return HUGEPAGE_OFF;
+  if (!strcmp(s, "thp")) return HUGEPAGE_THP;
+  if (!strcmp(s, "explicit")) return HUGEPAGE_EXPLICIT;
+  DIE("Unknown huge page mode \"%s\" (off, thp, explicit)\n", s);
+}
+
+const char *hugepage_mode_name(enum hugepage_mode m) {
+  switch (m) {
+    case HUGEPAGE_THP:
+      return "thp";
+    case HUGEPAGE_EXPLICIT:
+      return "explicit";
+    default:
+      return "off";
+  }
+}
+
+void hugepage_init(enum hugepage_mode m) { mode = m; }
+
+enum hugepage_mode hugepage_get_mode(void) { return mode; }
+
+static size_t round_up(size_t x, size_t to) { return (x + to - 1) & ~(to - 1); }
+
+/* A 2 MiB-aligned anonymous mapping, so THP can back all of it. */
+static void *map_thp(size_t len) {
+  char *p = mmap(NULL, len + HUGEPAGE_SIZE, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) return NULL;
+  char *aligned = (char *)round_up((uintptr_t)p, HUGEPAGE_SIZE);
+  if (aligned > p) munmap(p, aligned - p);
+  munmap(aligned + len, (p + len + HUGEPAGE_SIZE) - (aligned + len));
+#if defined(MADV_HUGEPAGE)
+  madvise(aligned, len, MADV_HUGEPAGE);
+#endif
+  return aligned;
+}
+
+static void *map_huge(size_t len) {
+  void *p = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+  if (mode == HUGEPAGE_EXPLICIT) {
+    static int warned = 0;
+    p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p == MAP_FAILED && !warned) {
+      warned = 1;
+      VERBOSE_PRINT("MAP_HUGETLB failed, using transparent huge pages\n");
+    }
+  }
+#endif
+  if (p == MAP_FAILED) p = map_thp(len);
+  return p;
+}
+
+void *hugepage_malloc(size_t size) {
+  if (mode == HUGEPAGE_OFF) return malloc(size);
+
+  struct hdr *h;
+  if (size + sizeof(*h) < HUGEPAGE_SIZE) {
+    // 64-byte aligned, so the payload after the header is too.
+    const int err = posix_memalign((void **)&h, 64, size + sizeof(*h));
+    if (err) {
+      errno = err;
+      return NULL;
+    }
+    h->kind = KIND_MALLOC;
+    h->base = h;
+    h->maplen = 0;
+  } else {
+    const size_t len = round_up(size + sizeof(*h), HUGEPAGE_SIZE);
+    h = map_huge(len);
+    if (!h) return NULL;
+    h->kind = KIND_MMAP;
+    h->base = h;
+    h->maplen = len;
+  }
+  h->magic = HDR_MAGIC;
+  h->size = size;
+  return h + 1;
+}
+
+void *hugepage_calloc(size_t n, size_t sz) {
+  if (mode == HUGEPAGE_OFF) return calloc(n, sz);
+  if (sz && n > SIZE_MAX / sz) return NULL;
+  void *p = hugepage_malloc(n * sz);
+  if (!p) return NULL;
+  /* Fresh mappings are already zero. */
+  if (((struct hdr *)p - 1)->kind == KIND_MALLOC) memset(p, 0, n * sz);
+  return p;
+}
+
+void hugepage_free(void *p) {
+  if (mode == HUGEPAGE_OFF) {
+    free(p);
+    return;
+  }
+  if (!p) return;
+  struct hdr *h = (struct hdr *)p - 1;
+  if (h->magic != HDR_MAGIC) DIE("hugepage_free: not a hugepage allocation\n");
+  h->magic = 0;
+  if (h->kind == KIND_MMAP)
+    munmap(h->base, h->maplen);
+  else
+    free(h->base);
+}
+
+void *hugepage_realloc(void *p, size_t size) {
+  if (mode == HUGEPAGE_OFF) return realloc(p, size);
+  if (!p) return hugepage_malloc(size);
+  struct hdr *h = (struct hdr *)p - 1;
+  if (h->magic != HDR_MAGIC)
+    DIE("hugepage_realloc: not a hugepage allocation\n");
+  if (size <= h->size && (h->kind == KIND_MALLOC || size + sizeof(*h) >= HUGEPAGE_SIZE)) {
+    h->size = size;
+    return p;
+  }
+  void *out = hugepage_malloc(size);
+  if (!out) return NULL;
+  memcpy(out, p, h->size < size ? h->size : size);
+  hugepage_free(p);
+  return out;
+}
+
+/* AnonHugePages of this process, in MiB, or -1 if unknown. */
+double hugepage_anon_huge_mib(void) {
+  FILE *f = fopen("/proc/self/smaps_rollup", "r");
+  if (!f) return -1;
+  char line[256];
+  double out = -1;
+  while (fgets(line, sizeof(line), f)) {
+    unsigned long kb;
+    if (sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) {
+      out = kb / 1024.0;
+      break;
+    }
+  }
+  fclose(f);
+  return out;
+}
@@ -0,0 +1,28 @@
+#if !defined(HUGEPAGE_HEADER_)
+#define HUGEPAGE_HEADER_
+#include <stddef.h>
+
+/* Allocator for the large edge and CSR arrays.  HUGEPAGE_OFF is plain
+   malloc / free.  The other modes back allocations of at least
+   HUGEPAGE_SIZE with 2 MiB pages, either transparent (madvise) or
+   explicit (MAP_HUGETLB, falling back to transparent when the pool is
+   empty).  The mode is fixed by hugepage_init before any allocation;
+   memory from hugepage_malloc must be released with hugepage_free. */
+
+#define HUGEPAGE_SIZE ((size_t)2 << 20)
+
+enum hugepage_mode { HUGEPAGE_OFF = 0, HUGEPAGE_THP, HUGEPAGE_EXPLICIT };
+
+enum hugepage_mode hugepage_mode_parse (const char *);
+const char *hugepage_mode_name (enum hugepage_mode);
+void hugepage_init (enum hugepage_mode);
+enum hugepage_mode hugepage_get_mode (void);
+
+void *hugepage_malloc (size_t);
+void *hugepage_calloc (size_t, size_t);
+void *hugepage_realloc (void *, size_t);
+void hugepage_free (void *);
+
+double hugepage_anon_huge_mib (void);
+
+#endif /* HUGEPAGE_HEADER_ */
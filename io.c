@@ -23,11 +23,28 @@
 
 #include "compat.h"
 #include "globals.h"
+#include "placement.h"
+#include "hugepage.h"
+#include "arena.h"
 
 extern struct gengetopt_args_info args;
 
+#if !defined(USE_SUITESPARSE)
+// LucataGraphBLAS copies on import, so the read buffers are scratch and
+// can be reused from one matrix (and run) to the next.
+#define CSR_BUF(slot, sz) arena_get (slot, sz)
+#define CSR_RELEASE(p) do { } while (0)
+#else
+// SuiteSparse takes ownership of imported arrays.
+#define CSR_BUF(slot, sz) hugepage_malloc (sz)
+#define CSR_RELEASE(p) hugepage_free (p)
+#endif
+
 static const char filetag[] = "mxmtimer";
 static const char reverse_filetag[] = "remitmxm";
+// The same layout with 32-bit column indices.
+static const char filetag32[] = "mxmtim32";
+static const char reverse_filetag32[] = "23mitmxm";
 
 int
 open_filename (const char* filename) {
@@ -85,9 +102,9 @@ make_mtx_from_file (GrB_Matrix *A_out, GrB_Index * NV_out, GrB_Index * NE_out, i
     if (NV_out) *NV_out = nrows;
     if (NE_out) *NE_out = nvals;
 
-    off = malloc((nrows+1) * sizeof(*off));
-    colind = malloc(nvals * sizeof(*colind));
-    val = malloc(nvals * sizeof(*val));
+    off = CSR_BUF(ARENA_CSR_OFF, (nrows+1) * sizeof(*off));
+    colind = CSR_BUF(ARENA_CSR_COLIND, nvals * sizeof(*colind));
+    val = CSR_BUF(ARENA_CSR_VAL, nvals * sizeof(*val));
     if (!off || !colind || !val)
         DIE_PERROR("Memory allocation failed reading matrix %s: ", name);
 
@@ -100,6 +117,10 @@ make_mtx_from_file (GrB_Matrix *A_out, GrB_Index * NV_out, GrB_Index * NE_out, i
     if (off[nrows] != nvals)
         DIE("off[nrows] != nvals reading %s\n", name);
 
+    // Set the NUMA policy before the first touch of colind and val.
+    placement_csr (placement_mode_parse (args.numa_arg), off, nrows,
+                   colind, sizeof (*colind), val, sizeof (*val));
+
     // Now the nvals colinds
     for (size_t k = 0; k < nvals; ++k) {
         long tmp;
@@ -126,9 +147,7 @@ make_mtx_from_file (GrB_Matrix *A_out, GrB_Index * NV_out, GrB_Index * NE_out, i
 
     *A_out = A;
 
-#if !defined(USE_SUITESPARSE)
-    free (val); free (colind); free (off);
-#endif
+    CSR_RELEASE (val); CSR_RELEASE (colind); CSR_RELEASE (off);
 
     fclose (f);
 
@@ -151,6 +170,14 @@ ensure_byteorder64 (uint64_t x, bool needs_bs)
 #endif
 }
 
+static inline uint32_t
+ensure_byteorder32 (uint32_t x, bool needs_bs)
+{
+    if (!needs_bs) return x;
+    x = (x >> 16) | (x << 16);
+    return ((x >> 8) & UINT32_C(0x00FF00FF)) | ((x & UINT32_C(0x00FF00FF)) << 8);
+}
+
 GrB_Info
 make_mtx_from_binfile (GrB_Matrix *A_out, GrB_Index * NV_out, GrB_Index * NE_out, int fd)
 {
@@ -169,9 +196,14 @@ make_mtx_from_binfile (GrB_Matrix *A_out, GrB_Index * NV_out, GrB_Index * NE_out
     GrB_Index *colind = NULL;
     uint64_t *val = NULL;
 
+    bool colind32 = false;
     read (fd, tag, 8);
     if (!strcmp(tag, reverse_filetag))
         needs_bs = true;
+    else if (!strcmp(tag, reverse_filetag32))
+        needs_bs = colind32 = true;
+    else if (!strcmp(tag, filetag32))
+        colind32 = true;
     else if (strcmp(tag, filetag))
         DIE("Unrecognized file tag %s\n", tag);
 
@@ -194,9 +226,9 @@ make_mtx_from_binfile (GrB_Matrix *A_out, GrB_Index * NV_out, GrB_Index * NE_out
     if (NV_out) *NV_out = nrows;
     if (NE_out) *NE_out = nvals;
 
-    off = malloc((nrows+1) * sizeof(*off));
-    colind = malloc(nvals * sizeof(*colind));
-    val = malloc(nvals * sizeof(*val));
+    off = CSR_BUF(ARENA_CSR_OFF, (nrows+1) * sizeof(*off));
+    colind = CSR_BUF(ARENA_CSR_COLIND, nvals * sizeof(*colind));
+    val = CSR_BUF(ARENA_CSR_VAL, nvals * sizeof(*val));
     if (!off || !colind || !val)
         DIE_PERROR("Memory allocation failed reading matrix %s: ", name);
 
@@ -209,9 +241,28 @@ make_mtx_from_binfile (GrB_Matrix *A_out, GrB_Index * NV_out, GrB_Index * NE_out
     if (off[nrows] != nvals)
         DIE("off[nrows] != nvals reading %s\n", name);
 
-    // Now the nvals colinds
-    read (fd, colind, 8 * nvals);
-    if (needs_bs) {
+    // Set the NUMA policy before the first touch of colind and val.
+    placement_csr (placement_mode_parse (args.numa_arg), off, nrows,
+                   colind, sizeof (*colind), val, sizeof (*val));
+
+    // Now the nvals colinds.  The importers take 64-bit indices, so
+    // 32-bit ones are read into the top half of colind and widened in
+    // place; going forward, each store lands below every unread entry.
+    // The loads go through memcpy, whose char access may alias the
+    // stores, so the compiler cannot move one past the other.
+    if (colind32) {
+        const char *colind32_buf = (const char *)colind + 4 * nvals;
+        read (fd, (char *)colind32_buf, 4 * nvals);
+        for (size_t k = 0; k < nvals; ++k) {
+            uint32_t c;
+            memcpy (&c, colind32_buf + 4 * k, sizeof (c));
+            colind[k] = ensure_byteorder32 (c, needs_bs);
+            if (colind[k] >= ncols)
+                DIE("Out of range column reading %s\n", name);
+        }
+    } else
+        read (fd, colind, 8 * nvals);
+    if (needs_bs && !colind32) {
         parfor (size_t k = 0; k < nvals; ++k) {
             colind[k] = ensure_byteorder64(colind[k], true);
             if (colind[k] >= ncols)
@@ -238,11 +289,58 @@ make_mtx_from_binfile (GrB_Matrix *A_out, GrB_Index * NV_out, GrB_Index * NE_out
 
     *A_out = A;
 
+    CSR_RELEASE (val); CSR_RELEASE (colind); CSR_RELEASE (off);
+
+    return GrB_SUCCESS;
+}
+
+void
+free_csr_copy (GrB_Index *off, GrB_Index *colind, uint64_t *val)
+{
 #if !defined(USE_SUITESPARSE)
+    // Allocated by LucataGraphBLAS, not through hugepage_malloc.
     free (val); free (colind); free (off);
+#else
+    hugepage_free (val); hugepage_free (colind); hugepage_free (off);
 #endif
+}
 
-    return GrB_SUCCESS;
+GrB_Info
+export_csr_copy (GrB_Matrix A, GrB_Index *nrows, GrB_Index *ncols, GrB_Index **off, GrB_Index **colind, uint64_t **val)
+{
+    GrB_Info info = GrB_SUCCESS;
+#if !defined(USE_SUITESPARSE)
+    info = LGB_Matrix_export_CSR_UINT64 (A, NULL, nrows, ncols, off, colind, val, NULL);
+#else
+    GrB_Matrix dupA;
+    info = GrB_Matrix_dup (&dupA, A);
+    if (info != GrB_SUCCESS) return info;
+
+    GrB_Type type;
+    GrB_Index off_size, colind_size, val_size;
+    bool is_uniformed;
+
+    // A NULL jumbled flag asks for sorted rows.
+    info = GxB_Matrix_export_CSR (&dupA, &type, nrows, ncols, off, colind, (void**)val, &off_size, &colind_size, &val_size, &is_uniformed, NULL, GrB_NULL);
+    if (info != GrB_SUCCESS) {
+        GrB_free (&dupA);
+        return info;
+    }
+
+    // Iso-valued matrices export a single value; expand it.
+    const GrB_Index nnz = (*off)[*nrows];
+    if (is_uniformed && nnz > 1) {
+        uint64_t *fullval = hugepage_malloc (nnz * sizeof (*fullval));
+        if (!fullval) {
+            free_csr_copy (*off, *colind, *val);
+            return GrB_OUT_OF_MEMORY;
+        }
+        for (GrB_Index k = 0; k < nnz; ++k) fullval[k] = (*val)[0];
+        hugepage_free (*val);
+        *val = fullval;
+    }
+#endif
+    return info;
 }
 
 void
@@ -261,36 +359,9 @@ make_file_from_mtx (GrB_Matrix A, const char *name, int fd)
       DIE_PERROR("Cannot duplicate file descriptor");
     FILE *f = fdopen (newfd, "w");
 
-#if !defined(USE_SUITESPARSE)
-    info = LGB_Matrix_export_CSR_UINT64 (A, NULL, &nrows, &ncols, &off, &colind, &val, NULL);
-
+    info = export_csr_copy (A, &nrows, &ncols, &off, &colind, &val);
     if (info != GrB_SUCCESS)
         DIE("Export of %s failed: %ld\n", name, (long)info);
-#else
-    {
-        GrB_Matrix dupA;
-        info = GrB_Matrix_dup (&dupA, A);
-        if (info != GrB_SUCCESS)
-            DIE("Duplicating matrix %s: %ld\n", name, (long)info);
-
-        GrB_Type type;
-        GrB_Index off_size, colind_size, val_size;
-        bool is_uniformed;
-        bool jumbled;
-
-        info = GxB_Matrix_export_CSR (&dupA, &type, &nrows, &ncols, &off, &colind, (void**)&val, &off_size, &colind_size, &val_size, &is_uniformed, &jumbled, GrB_NULL);
-        if (info != GrB_SUCCESS)
-            DIE("Export of %s failed: %ld\n", name, (long)info);
-
-        /* Not only is this not implemented, it's wrong. */
-        /* if (is_uniformed) */
-        /*     DIE("%s is wearing a funny hat.\n", name); */
-        if (jumbled)
-            DIE("Assumed %s is sorted and it ain't.", name);
-
-        GrB_free (&dupA);
-    }
-#endif
 
     GrB_Index nnz = off[nrows];
     DEBUG_PRINT("Writing name %s  dims %ld %ld %ld\n", name, (long)nrows, (long)ncols, (long)nnz);
@@ -333,9 +404,7 @@ make_file_from_mtx (GrB_Matrix A, const char *name, int fd)
         fprintf (f, "\n");
     }
 
-    free (val);
-    free (colind);
-    free (off);
+    free_csr_copy (off, colind, val);
 
     fclose (f);
 }
@@ -350,41 +419,19 @@ make_binfile_from_mtx (GrB_Matrix A, const char *name, int fd)
     GrB_Index *colind = NULL;
     uint64_t *val = NULL;
 
-#if !defined(USE_SUITESPARSE)
-    info = LGB_Matrix_export_CSR_UINT64 (A, NULL, &nrows, &ncols, &off, &colind, &val, NULL);
-
+    info = export_csr_copy (A, &nrows, &ncols, &off, &colind, &val);
     if (info != GrB_SUCCESS)
         DIE("Export of %s failed: %ld\n", name, (long)info);
-#else
-    {
-        GrB_Matrix dupA;
-        info = GrB_Matrix_dup (&dupA, A);
-        if (info != GrB_SUCCESS)
-            DIE("Duplicating matrix %s: %ld\n", name, (long)info);
-
-        GrB_Type type;
-        GrB_Index off_size, colind_size, val_size;
-        bool is_uniformed;
-        bool jumbled;
-
-        info = GxB_Matrix_export_CSR (&dupA, &type, &nrows, &ncols, &off, &colind, (void**)&val, &off_size, &colind_size, &val_size, &is_uniformed, &jumbled, GrB_NULL);
-        if (info != GrB_SUCCESS)
-            DIE("Export of %s failed: %ld\n", name, (long)info);
-
-        /* Not only is this not implemented, it's wrong. */
-        /* if (is_uniformed) */
-        /*     DIE("%s is wearing a funny hat.\n", name); */
-        if (jumbled)
-            DIE("Assumed %s is sorted and it ain't.", name);
-
-        GrB_free (&dupA);
-    }
-#endif
 
     GrB_Index nnz = off[nrows];
     DEBUG_PRINT("Writing name %s  dims %ld %ld %ld\n", name, (long)nrows, (long)ncols, (long)nnz);
 
-    write (fd, filetag, 8);
+    // --index-bits=32 halves the column indices on disk.
+    const bool colind32 = !strcmp (args.index_bits_arg, "32");
+    if (colind32 && ncols > (GrB_Index)UINT32_MAX + 1)
+        DIE("%s has too many columns for 32-bit indices\n", name);
+
+    write (fd, colind32 ? filetag32 : filetag, 8);
     uint64_t namelen = strlen(name)+1;
     write (fd, &namelen, 8);
     write (fd, name, namelen);
@@ -395,11 +442,18 @@ make_binfile_from_mtx (GrB_Matrix A, const char *name, int fd)
     write (fd, off, 8 * (nrows+1));
 
     if (nnz > 0) {
-        write (fd, colind, 8 * nnz);
+        if (colind32) {
+            uint32_t *colind32_buf = malloc (nnz * sizeof (*colind32_buf));
+            if (!colind32_buf)
+                DIE_PERROR("Cannot malloc 32-bit indices for %s", name);
+            parfor (size_t k = 0; k < nnz; ++k)
+                colind32_buf[k] = colind[k];
+            write (fd, colind32_buf, 4 * nnz);
+            free (colind32_buf);
+        } else
+            write (fd, colind, 8 * nnz);
         write (fd, val, 8 * nnz);
     }
 
-    free (val);
-    free (colind);
-    free (off);
+    free_csr_copy (off, colind, val);
 }
@@ -6,6 +6,11 @@ int open_filename (const char* filename);
 GrB_Info make_mtx_from_file (GrB_Matrix *A_out, GrB_Index * NV_out, GrB_Index * NE_out, int fd);
 GrB_Info make_mtx_from_binfile (GrB_Matrix *A_out, GrB_Index * NV_out, GrB_Index * NE_out, int fd);
 
+// Copy of A's CSR arrays with a full value array and sorted rows;
+// release with free_csr_copy.
+GrB_Info export_csr_copy (GrB_Matrix A, GrB_Index *nrows, GrB_Index *ncols, GrB_Index **off, GrB_Index **colind, uint64_t **val);
+void free_csr_copy (GrB_Index *off, GrB_Index *colind, uint64_t *val);
+
 void make_file_from_mtx (GrB_Matrix A, const char *name, int fd);
 void make_binfile_from_mtx (GrB_Matrix A, const char *name, int fd);
 
@@ -0,0 +1,153 @@
+#include "compat.h"
+#include "khop.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+int khop_init(struct khop *K, uint64_t n) {
+  memset(K, 0, sizeof(*K));
+  K->n = n;
+  K->nwords = (n + 63) / 64;
+  const size_t nw = K->nwords ? K->nwords : 1;
+  K->cur = calloc(nw, sizeof(*K->cur));
+  K->next = calloc(nw, sizeof(*K->next));
+  K->visited = calloc(nw, sizeof(*K->visited));
+  K->queue = malloc((n ? n : 1) * sizeof(*K->queue));
+  K->queue_next = malloc((n ? n : 1) * sizeof(*K->queue_next));
+  if (!K->cur || !K->next || !K->visited || !K->queue || !K->queue_next) {
+    khop_free(K);
+    errno = ENOMEM;
+    return -1;
+  }
+  return 0;
+}
+
+void khop_free(struct khop *K) {
+  free(K->queue_next);
+  free(K->queue);
+  free(K->visited);
+  free(K->next);
+  free(K->cur);
+  memset(K, 0, sizeof(*K));
+}
+
+/* The vertices set in bm, in no particular order; returns how many. */
+static uint64_t compact(uint64_t *restrict queue, const uint64_t *restrict bm,
+                        uint64_t nwords) {
+  uint64_t len = 0;
+  OMP(parallel for schedule(dynamic, 1024))
+  for (int64_t w = 0; w < (int64_t)nwords; ++w) {
+    uint64_t bits = bm[w];
+    if (!bits) continue;
+    uint64_t pos;
+    OMP(atomic capture)
+    { pos = len; len += __builtin_popcountll(bits); }
+    for (; bits; bits &= bits - 1)
+      queue[pos++] = 64 * w + __builtin_ctzll(bits);
+  }
+  return len;
+}
+
+static uint64_t popcount(const uint64_t *restrict bm, uint64_t nwords) {
+  uint64_t n = 0;
+  OMP(parallel for simd reduction(+ : n))
+  for (int64_t w = 0; w < (int64_t)nwords; ++w) n += __builtin_popcountll(bm[w]);
+  return n;
+}
+
+void khop_reset(struct khop *K, const uint64_t *roots, uint64_t nroots) {
+  memset(K->cur, 0, K->nwords * sizeof(*K->cur));
+  for (uint64_t r = 0; r < nroots; ++r)
+    K->cur[roots[r] / 64] |= (uint64_t)1 << (roots[r] % 64);
+  memcpy(K->visited, K->cur, K->nwords * sizeof(*K->cur));
+  K->count = compact(K->queue, K->cur, K->nwords);
+  K->have_queue = 1;
+  K->pushes = K->pulls = 0;
+}
+
+/* Scatter the queue along A^T's rows into next and its queue. */
+static uint64_t push(struct khop *K, const struct spgemm_csr *AT) {
+  uint64_t *restrict next = K->next;
+  uint64_t len = 0;
+  OMP(parallel for schedule(dynamic, 64))
+  for (int64_t q = 0; q < (int64_t)K->count; ++q) {
+    const uint64_t j = K->queue[q];
+    for (uint64_t k = AT->off[j]; k < AT->off[j + 1]; ++k) {
+      const uint64_t i = AT->colind[k], w = i / 64;
+      const uint64_t mask = (uint64_t)1 << (i % 64);
+      if (next[w] & mask) continue;
+      uint64_t old;
+      OMP(atomic capture)
+      { old = next[w]; next[w] |= mask; }
+      if (old & mask) continue;
+      uint64_t pos;
+      OMP(atomic capture)
+      pos = len++;
+      K->queue_next[pos] = i;
+    }
+  }
+  return len;
+}
+
+/* Each word of next is owned by one iteration, so no atomics. */
+static uint64_t pull(struct khop *K, const struct spgemm_csr *A) {
+  const uint64_t *restrict cur = K->cur;
+  uint64_t *restrict next = K->next;
+  const uint64_t n = K->n;
+  uint64_t count = 0;
+  OMP(parallel for schedule(dynamic, 64) reduction(+ : count))
+  for (int64_t w = 0; w < (int64_t)K->nwords; ++w) {
+    uint64_t bits = 0;
+    const uint64_t end = 64 * w + 64 < n ? 64 * w + 64 : n;
+    for (uint64_t i = 64 * w; i < end; ++i)
+      for (uint64_t k = A->off[i]; k < A->off[i + 1]; ++k) {
+        const uint64_t j = A->colind[k];
+        if (cur[j / 64] & ((uint64_t)1 << (j % 64))) {
+          bits |= (uint64_t)1 << (i % 64);
+          break;
+        }
+      }
+    next[w] = bits;
+    count += __builtin_popcountll(bits);
+  }
+  return count;
+}
+
+uint64_t khop_step(struct khop *K, const struct spgemm_csr *A,
+                   const struct spgemm_csr *AT, double dense_frac) {
+  const double cutoff = dense_frac * K->n;
+  uint64_t count;
+  if (K->have_queue && K->count <= cutoff) {
+    memset(K->next, 0, K->nwords * sizeof(*K->next));
+    count = push(K, AT);
+    K->have_queue = 1;
+    ++K->pushes;
+  } else {
+    count = pull(K, A);
+    K->have_queue = 0;
+    ++K->pulls;
+  }
+  if (!K->have_queue && count <= cutoff) {
+    compact(K->queue_next, K->next, K->nwords);
+    K->have_queue = 1;
+  }
+
+  uint64_t *tmp = K->cur;
+  K->cur = K->next;
+  K->next = tmp;
+  tmp = K->queue;
+  K->queue = K->queue_next;
+  K->queue_next = tmp;
+  K->count = count;
+
+  uint64_t *restrict visited = K->visited;
+  const uint64_t *restrict cur = K->cur;
+  OMP(parallel for simd)
+  for (int64_t w = 0; w < (int64_t)K->nwords; ++w) visited[w] |= cur[w];
+  return count;
+}
+
+uint64_t khop_visited(const struct khop *K) {
+  return popcount(K->visited, K->nwords);
+}
@@ -0,0 +1,33 @@
+#if !defined(KHOP_HEADER_)
+#define KHOP_HEADER_
+#include <stdint.h>
+
+#include "spgemm.h"
+
+/* Single-source k-hop frontier on A's CSR arrays: hop h + 1 holds the
+   vertices i with A(i, j) for some j in hop h, the pattern of one
+   column of B = A * B.  The frontier is a vertex bitmap, plus a queue
+   of its vertices while it is sparse.  A sparse frontier is pushed
+   along A^T's rows, and a dense one pulled through A's rows with an
+   early exit per row.  visited accumulates every frontier so far.
+   Functions return 0 on success and -1 with errno set otherwise. */
+
+struct khop {
+  uint64_t n, nwords;
+  uint64_t *cur, *next, *visited; /* bitmaps of nwords words */
+  uint64_t *queue, *queue_next;   /* cur as a list, if have_queue */
+  uint64_t count;                 /* vertices in cur */
+  int have_queue;
+  int pushes, pulls; /* hops run each way since khop_reset */
+};
+
+int khop_init (struct khop *, uint64_t n);
+void khop_reset (struct khop *, const uint64_t *roots, uint64_t nroots);
+/* One hop, pulled once more than dense_frac of the vertices are in the
+   frontier.  Returns the new frontier size. */
+uint64_t khop_step (struct khop *, const struct spgemm_csr *A,
+                    const struct spgemm_csr *AT, double dense_frac);
+uint64_t khop_visited (const struct khop *);
+void khop_free (struct khop *);
+
+#endif /* KHOP_HEADER_ */
@@ -0,0 +1,87 @@
+#define _GNU_SOURCE
+#include "compat.h"
+#include "perfctr.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+const char *perfctr_name(enum perfctr_event ev) {
+  switch (ev) {
+    case PERFCTR_DTLB_LOAD_MISSES:
+      return "dtlb_load_misses";
+    case PERFCTR_LLC_LOAD_MISSES:
+      return "llc_load_misses";
+    default:
+      return "unknown";
+  }
+}
+
+#if defined(__linux__) && defined(SYS_perf_event_open)
+#define PERFCTR_MAX_THREADS 1024
+
+/* One fd per (thread, event), opened by the thread itself so the OpenMP
+   pool threads are counted.  -2 is "not tried yet", -1 "unavailable". */
+static int fds[PERFCTR_MAX_THREADS][PERFCTR_NEVENTS];
+static int fds_init = 0;
+
+static int open_event(enum perfctr_event ev) {
+  struct perf_event_attr pe;
+  memset(&pe, 0, sizeof(pe));
+  pe.size = sizeof(pe);
+  pe.type = PERF_TYPE_HW_CACHE;
+  pe.config = (ev == PERFCTR_DTLB_LOAD_MISSES ? PERF_COUNT_HW_CACHE_DTLB
+                                              : PERF_COUNT_HW_CACHE_LL) |
+              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  pe.disabled = 1;
+  pe.exclude_kernel = 1;
+  pe.exclude_hv = 1;
+  return (int)syscall(SYS_perf_event_open, &pe, 0, -1, -1, 0);
+}
+
+void perfctr_begin(void) {
+  if (!fds_init) {
+    for (int t = 0; t < PERFCTR_MAX_THREADS; ++t)
+      for (int e = 0; e < PERFCTR_NEVENTS; ++e) fds[t][e] = -2;
+    fds_init = 1;
+  }
+  /* Threads may have been added since last time (--threads-sweep). */
+  OMP(parallel) {
+    const int t = omp_get_thread_num();
+    if (t < PERFCTR_MAX_THREADS)
+      for (int e = 0; e < PERFCTR_NEVENTS; ++e)
+        if (fds[t][e] == -2) fds[t][e] = open_event(e);
+  }
+  for (int t = 0; t < PERFCTR_MAX_THREADS; ++t)
+    for (int e = 0; e < PERFCTR_NEVENTS; ++e)
+      if (fds[t][e] >= 0) {
+        ioctl(fds[t][e], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds[t][e], PERF_EVENT_IOC_ENABLE, 0);
+      }
+}
+
+void perfctr_end(int64_t counts[PERFCTR_NEVENTS]) {
+  for (int e = 0; e < PERFCTR_NEVENTS; ++e) counts[e] = -1;
+  if (!fds_init) return;
+  for (int t = 0; t < PERFCTR_MAX_THREADS; ++t)
+    for (int e = 0; e < PERFCTR_NEVENTS; ++e)
+      if (fds[t][e] >= 0) {
+        uint64_t v;
+        ioctl(fds[t][e], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fds[t][e], &v, sizeof(v)) == sizeof(v))
+          counts[e] = (counts[e] < 0 ? 0 : counts[e]) + (int64_t)v;
+      }
+}
+#else
+void perfctr_begin(void) {}
+void perfctr_end(int64_t counts[PERFCTR_NEVENTS]) {
+  for (int e = 0; e < PERFCTR_NEVENTS; ++e) counts[e] = -1;
+}
+#endif
@@ -0,0 +1,19 @@
+#if !defined(PERFCTR_HEADER_)
+#define PERFCTR_HEADER_
+#include <stdint.h>
+
+/* Hardware event counts around a timed region, summed over the OpenMP
+   threads.  Counters that the kernel refuses (no PMU, restrictive
+   perf_event_paranoid) read as -1. */
+
+enum perfctr_event {
+  PERFCTR_DTLB_LOAD_MISSES = 0,
+  PERFCTR_LLC_LOAD_MISSES,
+  PERFCTR_NEVENTS
+};
+
+const char *perfctr_name (enum perfctr_event);
+void perfctr_begin (void);
+void perfctr_end (int64_t counts[PERFCTR_NEVENTS]);
+
+#endif /* PERFCTR_HEADER_ */
@@ -0,0 +1,227 @@
+#define _GNU_SOURCE
+#include "compat.h"
+#include "placement.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+#include "globals.h"
+
+extern int verbose;
+
+#define PLACEMENT_MAX_NODES 64
+
+/* From linux/mempolicy.h; spelled out so libnuma's headers are not
+   needed to build. */
+#define MPOL_BIND_ 2
+#define MPOL_INTERLEAVE_ 3
+#define MPOL_MF_MOVE_ (1 << 1)
+
+static int nnodes = -1;
+static unsigned long node_mask[PLACEMENT_MAX_NODES / (8 * sizeof(unsigned long)) + 1];
+
+/* Parse a sysfs list like "0-3,8,10-11" and call fn on each element. */
+static void for_each_in_list(const char *path, void (*fn)(int, void *),
+                             void *arg) {
+  FILE *f = fopen(path, "r");
+  if (!f) return;
+  char buf[4096];
+  if (!fgets(buf, sizeof(buf), f)) buf[0] = '\0';
+  fclose(f);
+  for (char *p = buf; *p && *p != '\n';) {
+    char *end;
+    long lo = strtol(p, &end, 10), hi = lo;
+    if (end == p) break;
+    if (*end == '-') hi = strtol(end + 1, &end, 10);
+    for (long k = lo; k <= hi; ++k) fn((int)k, arg);
+    p = end;
+    if (*p == ',') ++p;
+  }
+}
+
+static void count_node(int node, void *arg) {
+  int *maxnode = arg;
+  if (node < PLACEMENT_MAX_NODES) {
+    node_mask[node / (8 * sizeof(unsigned long))] |=
+        1ul << (node % (8 * sizeof(unsigned long)));
+    if (node + 1 > *maxnode) *maxnode = node + 1;
+  }
+}
+
+int placement_nnodes(void) {
+  if (nnodes < 0) {
+    nnodes = 0;
+    for_each_in_list("/sys/devices/system/node/online", count_node, &nnodes);
+    if (nnodes < 1) nnodes = 1;
+  }
+  return nnodes;
+}
+
+enum placement_mode placement_mode_parse(const char *s) {
+  if (!s || !strcmp(s, "none")) return PLACEMENT_NONE;
+  if (!strcmp(s, "interleave")) return PLACEMENT_INTERLEAVE;
+  if (!strcmp(s, "partition")) return PLACEMENT_PARTITION;
+  DIE("Unknown NUMA mode \"%s\" (none, interleave, partition)\n", s);
+}
+
+const char *placement_mode_name(enum placement_mode mode) {
+  switch (mode) {
+    case PLACEMENT_INTERLEAVE:
+      return "interleave";
+    case PLACEMENT_PARTITION:
+      return "partition";
+    default:
+      return "none";
+  }
+}
+
+#if defined(__linux__) && defined(SYS_mbind)
+static long sys_mbind(void *addr, unsigned long len, int mode,
+                      const unsigned long *nodemask, unsigned long maxnode,
+                      unsigned flags) {
+  return syscall(SYS_mbind, addr, len, mode, nodemask, maxnode, flags);
+}
+
+static void bind_range(void *p, size_t bytes, int mode, int node) {
+  static int warned = 0;
+  const uintptr_t pagesz = sysconf(_SC_PAGESIZE);
+  uintptr_t lo = ((uintptr_t)p) & ~(pagesz - 1);
+  uintptr_t hi = ((uintptr_t)p + bytes + pagesz - 1) & ~(pagesz - 1);
+  if (!bytes) return;
+
+  unsigned long one[PLACEMENT_MAX_NODES / (8 * sizeof(unsigned long)) + 1];
+  const unsigned long *mask = node_mask;
+  if (node >= 0) {
+    memset(one, 0, sizeof(one));
+    one[node / (8 * sizeof(unsigned long))] =
+        1ul << (node % (8 * sizeof(unsigned long)));
+    mask = one;
+  }
+  if (sys_mbind((void *)lo, hi - lo, mode, mask, PLACEMENT_MAX_NODES + 1,
+                MPOL_MF_MOVE_) &&
+      !warned) {
+    warned = 1;
+    VERBOSE_PRINT("mbind failed (%s), leaving pages where they are\n",
+                  strerror(errno));
+  }
+}
+#else
+static void bind_range(void *p, size_t bytes, int mode, int node) {
+  (void)p;
+  (void)bytes;
+  (void)mode;
+  (void)node;
+}
+#endif
+
+/* Bind each of nnodes row blocks (balanced by nonzeros) to its node.
+   Pages straddling a block boundary land on the later node. */
+static void partition_array(const uint64_t *off, size_t nrows, char *a,
+                            size_t elsz, int by_rows) {
+  const int nn = placement_nnodes();
+  const uint64_t nnz = off[nrows];
+  size_t row = 0;
+  for (int b = 0; b < nn; ++b) {
+    size_t row_end = row;
+    const uint64_t target = (nnz * (b + 1)) / nn;
+    while (row_end < nrows && off[row_end] < target) ++row_end;
+    if (b == nn - 1) row_end = nrows;
+    const size_t lo = by_rows ? row : off[row];
+    const size_t hi = by_rows ? row_end + (b == nn - 1) : off[row_end];
+    bind_range(a + lo * elsz, (hi - lo) * elsz, MPOL_BIND_, b);
+    row = row_end;
+  }
+}
+
+void placement_csr(enum placement_mode mode, const uint64_t *off, size_t nrows,
+                   void *colind, size_t colind_elsz, void *val,
+                   size_t val_elsz) {
+  if (mode == PLACEMENT_NONE || placement_nnodes() < 2) return;
+  const uint64_t nnz = off[nrows];
+  if (mode == PLACEMENT_INTERLEAVE) {
+    bind_range((void *)off, (nrows + 1) * sizeof(*off), MPOL_INTERLEAVE_, -1);
+    bind_range(colind, nnz * colind_elsz, MPOL_INTERLEAVE_, -1);
+    if (val) bind_range(val, nnz * val_elsz, MPOL_INTERLEAVE_, -1);
+  } else {
+    partition_array(off, nrows, (char *)off, sizeof(*off), 1);
+    partition_array(off, nrows, colind, colind_elsz, 0);
+    if (val) partition_array(off, nrows, val, val_elsz, 0);
+  }
+}
+
+#if defined(__linux__)
+struct cpu_set_arg {
+  cpu_set_t *set;
+};
+
+static void add_cpu(int cpu, void *arg) {
+  struct cpu_set_arg *a = arg;
+  if (cpu < CPU_SETSIZE) CPU_SET(cpu, a->set);
+}
+#endif
+
+/* Pin OpenMP threads in contiguous blocks per node, matching the row
+   blocks of PLACEMENT_PARTITION under a static schedule.  With
+   interleaving, each thread also gets an interleave policy so the
+   library's own allocations spread out. */
+void placement_pin_threads(enum placement_mode mode) {
+  if (mode == PLACEMENT_NONE || placement_nnodes() < 2) return;
+#if defined(__linux__)
+  const int nn = placement_nnodes();
+  cpu_set_t sets[PLACEMENT_MAX_NODES];
+  for (int b = 0; b < nn; ++b) {
+    char path[128];
+    struct cpu_set_arg a = {&sets[b]};
+    CPU_ZERO(&sets[b]);
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", b);
+    for_each_in_list(path, add_cpu, &a);
+  }
+
+  OMP(parallel) {
+    const int t = omp_get_thread_num();
+    const int nt = omp_get_num_threads();
+    const int b = (int)(((int64_t)t * nn) / nt);
+    if (CPU_COUNT(&sets[b]) > 0)
+      sched_setaffinity(0, sizeof(cpu_set_t), &sets[b]);
+#if defined(SYS_set_mempolicy)
+    if (mode == PLACEMENT_INTERLEAVE)
+      syscall(SYS_set_mempolicy, MPOL_INTERLEAVE_, node_mask,
+              PLACEMENT_MAX_NODES + 1);
+#endif
+  }
+#endif
+}
+
+/* Accumulate the number of resident pages of [p, p+bytes) on each node
+   into count[0..nnodes-1].  Unmapped pages are not counted. */
+void placement_count_pages(const void *p, size_t bytes, int64_t *count) {
+#if defined(__linux__) && defined(SYS_move_pages)
+  enum { BATCH = 4096 };
+  const uintptr_t pagesz = sysconf(_SC_PAGESIZE);
+  const int nn = placement_nnodes();
+  uintptr_t lo = ((uintptr_t)p) & ~(pagesz - 1);
+  const uintptr_t hi = (uintptr_t)p + bytes;
+  void *pages[BATCH];
+  int status[BATCH];
+
+  while (lo < hi) {
+    unsigned long n = 0;
+    for (; n < BATCH && lo < hi; ++n, lo += pagesz) pages[n] = (void *)lo;
+    if (syscall(SYS_move_pages, 0, n, pages, NULL, status, 0)) return;
+    for (unsigned long k = 0; k < n; ++k)
+      if (status[k] >= 0 && status[k] < nn) ++count[status[k]];
+  }
+#else
+  (void)p;
+  (void)bytes;
+  (void)count;
+#endif
+}
@@ -0,0 +1,25 @@
+#if !defined(PLACEMENT_HEADER_)
+#define PLACEMENT_HEADER_
+#include <stddef.h>
+#include <stdint.h>
+
+/* NUMA placement of CSR arrays and OpenMP threads.  Everything here
+   degrades to a no-op on single-node machines or kernels without the
+   mbind / move_pages system calls. */
+
+enum placement_mode {
+  PLACEMENT_NONE = 0,
+  PLACEMENT_INTERLEAVE, /* pages round-robin over all nodes */
+  PLACEMENT_PARTITION   /* row block b (by nnz) bound to node b */
+};
+
+enum placement_mode placement_mode_parse (const char *);
+const char *placement_mode_name (enum placement_mode);
+int placement_nnodes (void);
+
+void placement_pin_threads (enum placement_mode);
+void placement_csr (enum placement_mode, const uint64_t *off, size_t nrows,
+                    void *colind, size_t colind_elsz, void *val, size_t val_elsz);
+void placement_count_pages (const void *, size_t, int64_t *);
+
+#endif /* PLACEMENT_HEADER_ */
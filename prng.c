@@ -56,6 +56,12 @@ void init_prng(uint64_t* seeds_copy) {
   // scramble1 = ((uint64_t)out.v[2]) << 32 | (uint64_t)out.v[3];
 }
 
+/* Install seeds recorded elsewhere, such as in an edge list's header,
+   without looking at the environment. */
+void prng_set_seeds(const uint64_t* seeds) {
+  for (int i = 0; i < 4; i++) key.v[i] = seeds[i];
+}
+
 /* Apply a permutation to scramble vertex numbers; a randomly generated
  * permutation is not used because applying it at scale is too expensive. */
 int64_t scramble(int64_t v0) {
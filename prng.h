@@ -2,6 +2,7 @@
 #define PRNG_HEADER_
 
 void init_prng(uint64_t *);
+void prng_set_seeds(const uint64_t *);
 int64_t scramble(int64_t);
 uint8_t random_weight(int64_t);
 void random_edgevals(float *, int64_t);
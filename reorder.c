@@ -0,0 +1,266 @@
+#include "compat.h"
+#include "reorder.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "globals.h"
+
+extern int verbose;
+
+/* Label propagation stops after this many rounds, or earlier once
+   fewer than 1 in LP_SETTLED vertices change label. */
+#define LP_ROUNDS 8
+#define LP_SETTLED 1000
+
+enum reorder_mode reorder_mode_parse(const char *s) {
+  if (!s || !strcmp(s, "none")) return REORDER_NONE;
+  if (!strcmp(s, "degree")) return REORDER_DEGREE;
+  if (!strcmp(s, "rcm")) return REORDER_RCM;
+  if (!strcmp(s, "community")) return REORDER_COMMUNITY;
+  DIE("Unknown reordering \"%s\" (none, degree, rcm, community)\n", s);
+}
+
+const char *reorder_mode_name(enum reorder_mode m) {
+  switch (m) {
+    case REORDER_DEGREE:
+      return "degree";
+    case REORDER_RCM:
+      return "rcm";
+    case REORDER_COMMUNITY:
+      return "community";
+    default:
+      return "none";
+  }
+}
+
+/* Undirected adjacency: out- and in-edges of each vertex, self loops
+   dropped.  Parallel edges stay; they only weight the orders below. */
+struct adj {
+  uint64_t n;
+  uint64_t *off, *nbr;
+};
+
+static int adj_build(struct adj *g, uint64_t n, const uint64_t *off,
+                     const uint64_t *colind) {
+  g->n = n;
+  g->off = calloc(n + 1, sizeof(*g->off));
+  g->nbr = malloc((off[n] ? 2 * off[n] : 1) * sizeof(*g->nbr));
+  uint64_t *cursor = malloc((n ? n : 1) * sizeof(*cursor));
+  if (!g->off || !g->nbr || !cursor) {
+    free(cursor);
+    errno = ENOMEM;
+    return -1;
+  }
+  for (uint64_t i = 0; i < n; ++i)
+    for (uint64_t k = off[i]; k < off[i + 1]; ++k)
+      if (colind[k] != i) {
+        ++g->off[i + 1];
+        ++g->off[colind[k] + 1];
+      }
+  for (uint64_t i = 0; i < n; ++i) g->off[i + 1] += g->off[i];
+  memcpy(cursor, g->off, n * sizeof(*cursor));
+  for (uint64_t i = 0; i < n; ++i)
+    for (uint64_t k = off[i]; k < off[i + 1]; ++k) {
+      const uint64_t j = colind[k];
+      if (j == i) continue;
+      g->nbr[cursor[i]++] = j;
+      g->nbr[cursor[j]++] = i;
+    }
+  free(cursor);
+  return 0;
+}
+
+static void adj_free(struct adj *g) {
+  free(g->nbr);
+  free(g->off);
+}
+
+static inline uint64_t degree(const struct adj *g, uint64_t v) {
+  return g->off[v + 1] - g->off[v];
+}
+
+/* Vertices by degree, stable in vertex id; a counting sort. */
+static int by_degree(const struct adj *g, int descending, uint64_t *order) {
+  uint64_t maxdeg = 0;
+  for (uint64_t v = 0; v < g->n; ++v)
+    if (degree(g, v) > maxdeg) maxdeg = degree(g, v);
+  uint64_t *cnt = calloc(maxdeg + 2, sizeof(*cnt));
+  if (!cnt) {
+    errno = ENOMEM;
+    return -1;
+  }
+  for (uint64_t v = 0; v < g->n; ++v) {
+    const uint64_t d = degree(g, v);
+    ++cnt[(descending ? maxdeg - d : d) + 1];
+  }
+  for (uint64_t d = 0; d <= maxdeg; ++d) cnt[d + 1] += cnt[d];
+  for (uint64_t v = 0; v < g->n; ++v) {
+    const uint64_t d = degree(g, v);
+    order[cnt[descending ? maxdeg - d : d]++] = v;
+  }
+  free(cnt);
+  return 0;
+}
+
+static int cmp_pair(const void *pa, const void *pb) {
+  const uint64_t *a = pa, *b = pb;
+  if (a[0] != b[0]) return a[0] < b[0] ? -1 : 1;
+  return a[1] < b[1] ? -1 : a[1] > b[1];
+}
+
+/* Breadth-first from the lowest-degree unvisited vertex of each
+   component, each vertex's new neighbors queued by increasing degree,
+   then reversed. */
+static int order_rcm(const struct adj *g, uint64_t *order) {
+  const uint64_t n = g->n;
+  uint64_t *start = malloc((n ? n : 1) * sizeof(*start));
+  uint64_t *pairs = malloc((n ? 2 * n : 1) * sizeof(*pairs));
+  unsigned char *seen = calloc(n ? n : 1, 1);
+  if (!start || !pairs || !seen || by_degree(g, 0, start)) {
+    free(seen);
+    free(pairs);
+    free(start);
+    errno = ENOMEM;
+    return -1;
+  }
+  uint64_t tail = 0;
+  for (uint64_t s = 0; s < n; ++s) {
+    if (seen[start[s]]) continue;
+    seen[start[s]] = 1;
+    order[tail++] = start[s];
+    for (uint64_t head = tail - 1; head < tail; ++head) {
+      const uint64_t v = order[head], first = tail;
+      for (uint64_t k = g->off[v]; k < g->off[v + 1]; ++k) {
+        const uint64_t u = g->nbr[k];
+        if (seen[u]) continue;
+        seen[u] = 1;
+        pairs[2 * (tail - first)] = degree(g, u);
+        pairs[2 * (tail - first) + 1] = u;
+        ++tail;
+      }
+      qsort(pairs, tail - first, 2 * sizeof(*pairs), cmp_pair);
+      for (uint64_t t = first; t < tail; ++t) order[t] = pairs[2 * (t - first) + 1];
+    }
+  }
+  for (uint64_t a = 0, b = n; a + 1 < b; ++a, --b) {
+    const uint64_t t = order[a];
+    order[a] = order[b - 1];
+    order[b - 1] = t;
+  }
+  free(seen);
+  free(pairs);
+  free(start);
+  return 0;
+}
+
+/* Communities by label propagation, visiting hubs first so their
+   labels spread.  Each vertex takes its neighbors' most frequent label
+   (the smallest on ties).  Communities are then laid out contiguously,
+   largest first, and by decreasing degree within each, in the spirit
+   of Rabbit order without its modularity-driven merging. */
+static int order_community(const struct adj *g, uint64_t *order) {
+  const uint64_t n = g->n;
+  uint64_t *hubs = malloc((n ? n : 1) * sizeof(*hubs));
+  uint64_t *label = malloc((n ? n : 1) * sizeof(*label));
+  uint64_t *cnt = calloc(n ? n : 1, sizeof(*cnt));
+  uint64_t *touched = malloc((n ? n : 1) * sizeof(*touched));
+  uint64_t *pairs = NULL;
+  int rc = -1;
+  if (!hubs || !label || !cnt || !touched || by_degree(g, 1, hubs)) goto done;
+  for (uint64_t v = 0; v < n; ++v) label[v] = v;
+
+  for (int round = 0; round < LP_ROUNDS; ++round) {
+    uint64_t changed = 0;
+    for (uint64_t h = 0; h < n; ++h) {
+      const uint64_t v = hubs[h];
+      uint64_t ntouched = 0, best = label[v], best_cnt = 0;
+      for (uint64_t k = g->off[v]; k < g->off[v + 1]; ++k) {
+        const uint64_t l = label[g->nbr[k]];
+        if (!cnt[l]++) touched[ntouched++] = l;
+        if (cnt[l] > best_cnt || (cnt[l] == best_cnt && l < best)) {
+          best = l;
+          best_cnt = cnt[l];
+        }
+      }
+      for (uint64_t t = 0; t < ntouched; ++t) cnt[touched[t]] = 0;
+      if (best != label[v]) {
+        label[v] = best;
+        ++changed;
+      }
+    }
+    VERBOSELVL_PRINT(2, "  label propagation round %d: %lu changed\n",
+                     round + 1, (unsigned long)changed);
+    if (changed * LP_SETTLED < n) break;
+  }
+
+  /* cnt becomes community sizes, then each community's first slot. */
+  for (uint64_t v = 0; v < n; ++v) ++cnt[label[v]];
+  uint64_t ncomm = 0;
+  pairs = malloc((n ? 2 * n : 1) * sizeof(*pairs));
+  if (!pairs) goto done;
+  for (uint64_t l = 0; l < n; ++l)
+    if (cnt[l]) {
+      pairs[2 * ncomm] = n - cnt[l];
+      pairs[2 * ncomm + 1] = l;
+      ++ncomm;
+    }
+  qsort(pairs, ncomm, 2 * sizeof(*pairs), cmp_pair);
+  for (uint64_t c = 0, pos = 0; c < ncomm; ++c) {
+    const uint64_t l = pairs[2 * c + 1], size = cnt[l];
+    cnt[l] = pos;
+    pos += size;
+  }
+  for (uint64_t h = 0; h < n; ++h) order[cnt[label[hubs[h]]]++] = hubs[h];
+  rc = 0;
+
+done:
+  free(pairs);
+  free(touched);
+  free(cnt);
+  free(label);
+  free(hubs);
+  if (rc) errno = ENOMEM;
+  return rc;
+}
+
+int reorder_perm(enum reorder_mode mode, uint64_t n, const uint64_t *off,
+                 const uint64_t *colind, uint64_t *perm) {
+  if (mode == REORDER_NONE) {
+    for (uint64_t v = 0; v < n; ++v) perm[v] = v;
+    return 0;
+  }
+  struct adj g;
+  memset(&g, 0, sizeof(g));
+  uint64_t *order = malloc((n ? n : 1) * sizeof(*order));
+  int rc = !order ? -1 : adj_build(&g, n, off, colind);
+  if (!rc) {
+    if (mode == REORDER_DEGREE)
+      rc = by_degree(&g, 1, order);
+    else if (mode == REORDER_RCM)
+      rc = order_rcm(&g, order);
+    else
+      rc = order_community(&g, order);
+  }
+  if (!rc)
+    for (uint64_t k = 0; k < n; ++k) perm[order[k]] = k;
+  adj_free(&g);
+  free(order);
+  if (rc) errno = ENOMEM;
+  return rc;
+}
+
+double reorder_mean_gap(uint64_t n, const uint64_t *off,
+                        const uint64_t *colind, const uint64_t *perm) {
+  double sum = 0.0;
+  OMP(parallel for reduction(+ : sum) schedule(dynamic, 256))
+  for (int64_t i = 0; i < (int64_t)n; ++i)
+    for (uint64_t k = off[i]; k < off[i + 1]; ++k) {
+      const uint64_t a = perm ? perm[i] : (uint64_t)i;
+      const uint64_t b = perm ? perm[colind[k]] : colind[k];
+      sum += a > b ? a - b : b - a;
+    }
+  return off[n] ? sum / off[n] : 0.0;
+}
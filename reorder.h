@@ -0,0 +1,28 @@
+#if !defined(REORDER_HEADER_)
+#define REORDER_HEADER_
+#include <stdint.h>
+
+/* Locality-improving vertex orders, computed from A's pattern with
+   edges taken as undirected.  scramble() spreads R-MAT's hubs across
+   the index space; these pull related vertices back together before
+   the hop loop.  perm[old] = new.  Functions return 0 on success and
+   -1 with errno set otherwise. */
+
+enum reorder_mode {
+  REORDER_NONE = 0,
+  REORDER_DEGREE,   /* by decreasing degree */
+  REORDER_RCM,      /* reverse Cuthill-McKee */
+  REORDER_COMMUNITY /* label-propagation communities, kept contiguous */
+};
+
+enum reorder_mode reorder_mode_parse (const char *);
+const char *reorder_mode_name (enum reorder_mode);
+
+int reorder_perm (enum reorder_mode, uint64_t n, const uint64_t *off,
+                  const uint64_t *colind, uint64_t *perm);
+/* Mean |perm[i] - perm[j]| over the entries (i, j); NULL perm is the
+   identity. */
+double reorder_mean_gap (uint64_t n, const uint64_t *off,
+                         const uint64_t *colind, const uint64_t *perm);
+
+#endif /* REORDER_HEADER_ */
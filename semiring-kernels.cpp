@@ -0,0 +1,144 @@
+#include "semiring-kernels.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "semiring.hpp"
+
+namespace {
+
+template <class I>
+semiring::csr<I, uint64_t> view(const kernel_csr &M) {
+  semiring::csr<I, uint64_t> out;
+  out.nrows = M.nrows;
+  out.ncols = M.ncols;
+  out.off = M.off;
+  out.colind = static_cast<I *>(M.colind);
+  out.val = M.val;
+  out.off_cap = M.off_cap;
+  out.nnz_cap = M.nnz_cap;
+  return out;
+}
+
+template <class I>
+void store(kernel_csr &M, const semiring::csr<I, uint64_t> &in) {
+  M.nrows = in.nrows;
+  M.ncols = in.ncols;
+  M.off = in.off;
+  M.colind = in.colind;
+  M.val = in.val;
+  M.off_cap = in.off_cap;
+  M.nnz_cap = in.nnz_cap;
+  M.index_bits = 8 * sizeof(I);
+}
+
+/* A matrix changing index width drops its arrays, whose capacities
+   were counted in the old width. */
+void retype(kernel_csr &M, int index_bits) {
+  if (M.index_bits == index_bits) return;
+  kernel_free(&M);
+  M.index_bits = index_bits;
+}
+
+template <class I, class SR>
+int mxm(kernel_csr *C, const kernel_csr *A, const kernel_csr *B) {
+  constexpr int bits = 8 * sizeof(I);
+  if (A->index_bits != bits || B->index_bits != bits || C == A || C == B) {
+    errno = EINVAL;
+    return -1;
+  }
+  retype(*C, bits);
+  auto c = view<I>(*C);
+  const bool ok = semiring::mxm<I, uint64_t, SR>(c, view<I>(*A), view<I>(*B));
+  store(*C, c);
+  if (!ok) {
+    errno = A->ncols != B->nrows ? EINVAL : ENOMEM;
+    return -1;
+  }
+  return 0;
+}
+
+const kernel_mxm_fn table[2][3] = {
+    {mxm<uint32_t, semiring::min_first<uint64_t>>,
+     mxm<uint32_t, semiring::plus_times<uint64_t>>,
+     mxm<uint32_t, semiring::any_pair<uint64_t>>},
+    {mxm<uint64_t, semiring::min_first<uint64_t>>,
+     mxm<uint64_t, semiring::plus_times<uint64_t>>,
+     mxm<uint64_t, semiring::any_pair<uint64_t>>},
+};
+
+template <class I>
+int convert(kernel_csr *M, uint64_t nrows, uint64_t ncols,
+            const uint64_t *off, const uint64_t *colind, const uint64_t *val) {
+  auto m = view<I>(*M);
+  const uint64_t nnz = off[nrows];
+  if (!semiring::reserve(m, nrows, nnz)) {
+    store(*M, m);
+    errno = ENOMEM;
+    return -1;
+  }
+  m.nrows = nrows;
+  m.ncols = ncols;
+  std::memcpy(m.off, off, (nrows + 1) * sizeof(*off));
+#pragma omp parallel for
+  for (int64_t k = 0; k < (int64_t)nnz; ++k) {
+    m.colind[k] = static_cast<I>(colind[k]);
+    m.val[k] = val[k];
+  }
+  store(*M, m);
+  return 0;
+}
+
+}  // namespace
+
+extern "C" {
+
+kernel_mxm_fn kernel_select(int index_bits, enum kernel_semiring sr) {
+  if ((index_bits != 32 && index_bits != 64) || sr < KERNEL_MIN_FIRST ||
+      sr > KERNEL_ANY_PAIR)
+    return nullptr;
+  return table[index_bits == 64][sr];
+}
+
+const char *kernel_semiring_name(enum kernel_semiring sr) {
+  switch (sr) {
+    case KERNEL_PLUS_TIMES:
+      return "plus-times";
+    case KERNEL_ANY_PAIR:
+      return "any-pair";
+    default:
+      return "min-first";
+  }
+}
+
+int kernel_from_csr(struct kernel_csr *M, int index_bits, uint64_t nrows,
+                    uint64_t ncols, const uint64_t *off,
+                    const uint64_t *colind, const uint64_t *val) {
+  if (index_bits == 32 && ncols > UINT32_MAX + UINT64_C(1)) {
+    errno = ERANGE;
+    return -1;
+  }
+  if (index_bits != 32 && index_bits != 64) {
+    errno = EINVAL;
+    return -1;
+  }
+  retype(*M, index_bits);
+  return index_bits == 32
+             ? convert<uint32_t>(M, nrows, ncols, off, colind, val)
+             : convert<uint64_t>(M, nrows, ncols, off, colind, val);
+}
+
+uint64_t kernel_nvals(const struct kernel_csr *M) {
+  return M->off ? M->off[M->nrows] : 0;
+}
+
+void kernel_free(struct kernel_csr *M) {
+  const int index_bits = M->index_bits;
+  std::free(M->val);
+  std::free(M->colind);
+  std::free(M->off);
+  std::memset(M, 0, sizeof(*M));
+  M->index_bits = index_bits;
+}
+
+}  // extern "C"
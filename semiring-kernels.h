@@ -0,0 +1,48 @@
+#if !defined(SEMIRING_KERNELS_HEADER_)
+#define SEMIRING_KERNELS_HEADER_
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* C entry points to the templated kernels of semiring.hpp, instantiated
+   for 32- and 64-bit column indices, uint64_t values, and each
+   semiring.  kernel_select runs once; the function it returns has the
+   semiring and index width fixed at compile time.  Functions return 0
+   on success and -1 with errno set otherwise. */
+
+enum kernel_semiring {
+  KERNEL_MIN_FIRST = 0,
+  KERNEL_PLUS_TIMES,
+  KERNEL_ANY_PAIR
+};
+
+struct kernel_csr {
+  uint64_t nrows, ncols;
+  uint64_t *off;
+  void *colind; /* uint32_t or uint64_t, per index_bits */
+  uint64_t *val;
+  size_t off_cap, nnz_cap;
+  int index_bits;
+};
+
+typedef int (*kernel_mxm_fn) (struct kernel_csr *C, const struct kernel_csr *A,
+                              const struct kernel_csr *B);
+
+/* NULL unless index_bits is 32 or 64. */
+kernel_mxm_fn kernel_select (int index_bits, enum kernel_semiring);
+const char *kernel_semiring_name (enum kernel_semiring);
+
+int kernel_from_csr (struct kernel_csr *, int index_bits, uint64_t nrows,
+                     uint64_t ncols, const uint64_t *off,
+                     const uint64_t *colind, const uint64_t *val);
+uint64_t kernel_nvals (const struct kernel_csr *);
+void kernel_free (struct kernel_csr *);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* SEMIRING_KERNELS_HEADER_ */
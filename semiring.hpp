@@ -0,0 +1,156 @@
+// -*- C++ -*-
+#if !defined(SEMIRING_HPP_)
+#define SEMIRING_HPP_
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+/* Sparse matrix multiply specialized at compile time on the column
+   index type I, the value type V, and the semiring, so the inner loops
+   carry no per-element dispatch.  Row-wise Gustavson as in spgemm.c: a
+   symbolic pass sizes each output row with a stamped dense
+   accumulator, a numeric pass fills it in place.  Row offsets are
+   always 64-bit.  Header-only; semiring-kernels.cpp instantiates it
+   for the timer. */
+
+namespace semiring {
+
+template <class V>
+struct min_first {
+  static V mult(V a, V) { return a; }
+  static V add(V x, V y) { return y < x ? y : x; }
+};
+
+template <class V>
+struct plus_times {
+  static V mult(V a, V b) { return a * b; }
+  static V add(V x, V y) { return x + y; }
+};
+
+/* Reachability: every product is 1 and any one of them is the sum. */
+template <class V>
+struct any_pair {
+  static V mult(V, V) { return 1; }
+  static V add(V x, V) { return x; }
+};
+
+/* Arrays come from malloc and grow only, so a matrix reused across
+   products stops allocating once it has seen its largest result. */
+template <class I, class V>
+struct csr {
+  uint64_t nrows = 0, ncols = 0;
+  uint64_t *off = nullptr; /* nrows + 1 */
+  I *colind = nullptr;     /* off[nrows] */
+  V *val = nullptr;        /* off[nrows] */
+  size_t off_cap = 0, nnz_cap = 0;
+};
+
+template <class T>
+bool grow(T *&p, size_t &cap, size_t n) {
+  if (n <= cap && p) return true;
+  std::free(p);
+  p = static_cast<T *>(std::malloc((n ? n : 1) * sizeof(T)));
+  cap = p ? n : 0;
+  return p != nullptr;
+}
+
+template <class I, class V>
+bool reserve(csr<I, V> &M, uint64_t nrows, uint64_t nnz) {
+  size_t colind_cap = M.nnz_cap;
+  return grow(M.off, M.off_cap, nrows + 1) &&
+         grow(M.colind, colind_cap, nnz) && grow(M.val, M.nnz_cap, nnz);
+}
+
+template <class I, class V>
+void release(csr<I, V> &M) {
+  std::free(M.val);
+  std::free(M.colind);
+  std::free(M.off);
+  M = csr<I, V>();
+}
+
+/* C = A (+.x) B.  False if the shapes disagree, C aliases an input, or
+   an allocation fails.  Columns within a row of C come out in
+   accumulator order. */
+template <class I, class V, class SR>
+bool mxm(csr<I, V> &C, const csr<I, V> &A, const csr<I, V> &B) {
+  if (A.ncols != B.nrows || &C == &A || &C == &B) return false;
+  const int64_t nrows = A.nrows;
+  if (!reserve(C, nrows, 0)) return false;
+  C.nrows = nrows;
+  C.ncols = B.ncols;
+  C.off[0] = 0;
+
+  bool err = false;
+#pragma omp parallel
+  {
+    /* mark[j] is 2i + 1 once row i's symbolic pass saw j, 2i + 2 once
+       its numeric pass did, so nothing is cleared between rows. */
+    const size_t nc = B.ncols ? B.ncols : 1;
+    uint64_t *mark = static_cast<uint64_t *>(std::calloc(nc, sizeof(*mark)));
+    V *acc = static_cast<V *>(std::malloc(nc * sizeof(*acc)));
+    if (!mark || !acc) {
+#pragma omp atomic write
+      err = true;
+    }
+
+#pragma omp for schedule(dynamic, 256)
+    for (int64_t i = 0; i < nrows; ++i) {
+      uint64_t n = 0;
+      if (mark && acc) {
+        const uint64_t stamp = 2 * i + 1;
+        for (uint64_t ka = A.off[i]; ka < A.off[i + 1]; ++ka) {
+          const I k = A.colind[ka];
+          for (uint64_t kb = B.off[k]; kb < B.off[k + 1]; ++kb) {
+            const I j = B.colind[kb];
+            if (mark[j] != stamp) {
+              mark[j] = stamp;
+              ++n;
+            }
+          }
+        }
+      }
+      C.off[i + 1] = n;
+    }
+
+#pragma omp single
+    {
+      if (!err) {
+        for (int64_t i = 0; i < nrows; ++i) C.off[i + 1] += C.off[i];
+        if (!reserve(C, nrows, C.off[nrows])) err = true;
+      }
+    }
+
+#pragma omp for schedule(dynamic, 256)
+    for (int64_t i = 0; i < nrows; ++i) {
+      if (err) continue;
+      I *__restrict ci = C.colind + C.off[i];
+      V *__restrict cv = C.val + C.off[i];
+      const uint64_t stamp = 2 * i + 2;
+      uint64_t n = 0;
+      for (uint64_t ka = A.off[i]; ka < A.off[i + 1]; ++ka) {
+        const I k = A.colind[ka];
+        const V a = A.val[ka];
+        for (uint64_t kb = B.off[k]; kb < B.off[k + 1]; ++kb) {
+          const I j = B.colind[kb];
+          const V x = SR::mult(a, B.val[kb]);
+          if (mark[j] != stamp) {
+            mark[j] = stamp;
+            acc[j] = x;
+            ci[n++] = j;
+          } else
+            acc[j] = SR::add(acc[j], x);
+        }
+      }
+      for (uint64_t t = 0; t < n; ++t) cv[t] = acc[ci[t]];
+    }
+    std::free(acc);
+    std::free(mark);
+  }
+  return !err;
+}
+
+}  // namespace semiring
+
+#endif /* SEMIRING_HPP_ */
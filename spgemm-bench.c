@@ -0,0 +1,176 @@
+/* -*- C -*- */
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "compat.h"
+#include "generator.h"
+#include "globals.h"
+#include "hooks.h"
+#include "prng.h"  // for sample_roots
+#include "spgemm-bench-cmdline.h"
+#include "spgemm.h"
+
+/* Times each native accumulator on the products the timer runs: the
+   hop loop's A * B with a tall, skinny B at several widths, and
+   optionally the square A * A of --run-powers.  One "SpGEMM
+   accumulator" record per product, then one "SpGEMM accumulator best"
+   record per (scale, shape, width, hop) naming the fastest. */
+
+int verbose = 0;
+
+struct gengetopt_args_info args;
+
+#define MAX_ACCUMS 8
+
+static double wall_ms(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return 1.0e3 * t.tv_sec + 1.0e-6 * t.tv_nsec;
+}
+
+static void make_A(struct spgemm_csr *A) {
+  int64_t *I = malloc(NE * sizeof(*I));
+  int64_t *J = malloc(NE * sizeof(*J));
+  uint64_t *V = malloc(NE * sizeof(*V));
+  if (!I || !J || !V) DIE_PERROR("Cannot malloc edge list");
+  edge_list_64(I, J, V, 0, NE, NULL);
+  if (spgemm_from_tuples(A, NV, NV, I, J, V, NE))
+    DIE_PERROR("Cannot build A");
+  free(V);
+  free(J);
+  free(I);
+}
+
+/* As the timer's make_B, but with every column used. */
+static void make_B(struct spgemm_csr *B, int64_t ncols, int nents_per_col) {
+  const int64_t nroot = ncols * nents_per_col;
+  if (nroot > NV) DIE("B needs %ld roots but A has %ld rows\n", (long)nroot, (long)NV);
+  int64_t *I = malloc(nroot * sizeof(*I));
+  int64_t *J = malloc(nroot * sizeof(*J));
+  uint64_t *V = malloc(nroot * sizeof(*V));
+  if (!I || !J || !V) DIE_PERROR("Cannot malloc roots");
+  sample_roots(I, nroot, NV * nroot);
+  for (int64_t k = 0; k < nroot; ++k) {
+    J[k] = k / nents_per_col;
+    V[k] = 1;
+  }
+  if (spgemm_from_tuples(B, NV, ncols, I, J, V, nroot))
+    DIE_PERROR("Cannot build B");
+  free(V);
+  free(J);
+  free(I);
+}
+
+/* Time hops products B = A * B0, A * (A * B0), ... with each
+   accumulator, then report the fastest per hop. */
+static void run_shape(const char *shape, const struct spgemm_csr *A,
+                      const struct spgemm_csr *B0, int hops,
+                      const enum spgemm_accum *accums, int n_accums) {
+  struct spgemm_csr B = {0}, C = {0};
+  double *best_ms = malloc(hops * sizeof(*best_ms));
+  int *best = malloc(hops * sizeof(*best));
+  if (!best_ms || !best) DIE_PERROR("Cannot malloc timings");
+  for (int h = 0; h < hops; ++h) best[h] = -1;
+
+  for (int a = 0; a < n_accums; ++a) {
+    if (spgemm_copy(&B, B0)) DIE_PERROR("Cannot copy B");
+    for (int h = 0; h < hops; ++h) {
+      const uint64_t flops = spgemm_flops(A, &B);
+      hooks_set_attr_i64("scale", SCALE);
+      hooks_set_attr_i64("edgefactor", EF);
+      hooks_set_attr_str("shape", shape);
+      hooks_set_attr_i64("b_ncols", B.ncols);
+      hooks_set_attr_str("accum", spgemm_accum_name(accums[a]));
+      hooks_set_attr_i64("hop", h + 1);
+      hooks_set_attr_i64("nvals_A", A->off[A->nrows]);
+      hooks_set_attr_i64("nvals_B", B.off[B.nrows]);
+      hooks_set_attr_i64("flops", flops);
+      hooks_region_begin("SpGEMM accumulator");
+      const double t0 = wall_ms();
+      if (spgemm_mxm(&C, A, &B, SPGEMM_MIN_FIRST, accums[a]))
+        DIE_PERROR("SpGEMM failed");
+      const double t = wall_ms() - t0;
+      hooks_set_attr_i64("nvals_C", C.off[C.nrows]);
+      hooks_set_attr_f64("mflops_per_s", t > 0 ? flops / (1.0e3 * t) : 0);
+      hooks_region_end();
+      VERBOSE_PRINT("  %s %-6s hop %d: %g ms\n", shape,
+                    spgemm_accum_name(accums[a]), h + 1, t);
+
+      if (best[h] < 0 || t < best_ms[h]) {
+        best[h] = a;
+        best_ms[h] = t;
+      }
+      struct spgemm_csr tmp = B;
+      B = C;
+      C = tmp;
+    }
+  }
+
+  for (int h = 0; h < hops; ++h) {
+    hooks_set_attr_i64("scale", SCALE);
+    hooks_set_attr_str("shape", shape);
+    hooks_set_attr_i64("b_ncols", B0->ncols);
+    hooks_set_attr_i64("hop", h + 1);
+    hooks_set_attr_str("best_accum", spgemm_accum_name(accums[best[h]]));
+    hooks_set_attr_f64("best_wall_ms", best_ms[h]);
+    hooks_region_begin("SpGEMM accumulator best");
+    hooks_region_end();
+  }
+
+  free(best);
+  free(best_ms);
+  spgemm_free(&C);
+  spgemm_free(&B);
+}
+
+int main(int argc, char **argv) {
+  if (0 != cmdline_parser(argc, argv, &args)) exit(1);
+  if (NULL != getenv("VERBOSE")) {
+    long lvl = strtol(getenv("VERBOSE"), NULL, 10);
+    if (lvl > 1) verbose = lvl;
+  }
+  if (args.verbose_given) verbose = args.verbose_arg;
+
+  int n_scales, n_widths, n_accums = 0;
+  long *scales = parse_long_list(args.scales_arg, "scale", &n_scales);
+  long *widths = parse_long_list(args.b_ncols_arg, "B width", &n_widths);
+  enum spgemm_accum accums[MAX_ACCUMS];
+  char *saveptr = NULL;
+  for (char *tok = strtok_r(args.accums_arg, " ,\n", &saveptr); tok;
+       tok = strtok_r(NULL, " ,\n", &saveptr)) {
+    if (n_accums == MAX_ACCUMS) DIE("Too many accumulators\n");
+    accums[n_accums++] = spgemm_accum_parse(tok);
+  }
+  if (!n_accums) DIE("No accumulators given\n");
+  if (args.hops_arg <= 0) DIE("Invalid hop count: %d\n", args.hops_arg);
+
+  for (int s = 0; s < n_scales; ++s) {
+    if (scales[s] > SCALE_MAX) DIE("Scale %ld is too large\n", scales[s]);
+    init_globals(scales[s], args.edgefactor_arg, 255,
+                 1,  // unused
+                 args.A_arg, args.B_arg, args.noisefact_arg, 1);
+
+    struct spgemm_csr A = {0}, B0 = {0};
+    VERBOSE_PRINT("Scale %ld: generating A... ", scales[s]);
+    make_A(&A);
+    VERBOSE_PRINT("%" PRIu64 " entries\n", A.off[A.nrows]);
+
+    for (int w = 0; w < n_widths; ++w) {
+      make_B(&B0, widths[w], args.b_nents_col_arg);
+      run_shape("AxB", &A, &B0, args.hops_arg, accums, n_accums);
+    }
+    if (args.square_flag) run_shape("AxA", &A, &A, 1, accums, n_accums);
+
+    spgemm_free(&B0);
+    spgemm_free(&A);
+  }
+
+  free(widths);
+  free(scales);
+  cmdline_parser_free(&args);
+  return 0;
+}
@@ -0,0 +1,868 @@
+#include "compat.h"
+#include "spgemm.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "globals.h"
+#include "hugepage.h"
+
+enum spgemm_accum spgemm_accum_parse(const char *s) {
+  if (!s || !strcmp(s, "auto")) return SPGEMM_ACCUM_AUTO;
+  if (!strcmp(s, "dense")) return SPGEMM_ACCUM_DENSE;
+  if (!strcmp(s, "hash")) return SPGEMM_ACCUM_HASH;
+  if (!strcmp(s, "heap")) return SPGEMM_ACCUM_HEAP;
+  if (!strcmp(s, "bitmap")) return SPGEMM_ACCUM_BITMAP;
+  DIE("Unknown accumulator \"%s\" (auto, dense, hash, heap, bitmap)\n", s);
+}
+
+const char *spgemm_accum_name(enum spgemm_accum a) {
+  switch (a) {
+    case SPGEMM_ACCUM_DENSE:
+      return "dense";
+    case SPGEMM_ACCUM_HASH:
+      return "hash";
+    case SPGEMM_ACCUM_HEAP:
+      return "heap";
+    case SPGEMM_ACCUM_BITMAP:
+      return "bitmap";
+    default:
+      return "auto";
+  }
+}
+
+static int grow(uint64_t **p, size_t *cap, size_t n) {
+  if (n <= *cap && *p) return 0;
+  hugepage_free(*p);
+  *p = hugepage_malloc((n ? n : 1) * sizeof(**p));
+  *cap = *p ? n : 0;
+  if (!*p) {
+    errno = ENOMEM;
+    return -1;
+  }
+  return 0;
+}
+
+static int grow32(uint32_t **p, size_t *cap, size_t n) {
+  if (n <= *cap && *p) return 0;
+  hugepage_free(*p);
+  *p = hugepage_malloc((n ? n : 1) * sizeof(**p));
+  *cap = *p ? n : 0;
+  if (!*p) {
+    errno = ENOMEM;
+    return -1;
+  }
+  return 0;
+}
+
+int spgemm_reserve(struct spgemm_csr *M, uint64_t nrows, uint64_t nnz) {
+  size_t colind_cap = M->nnz_cap;
+  if (grow(&M->off, &M->off_cap, nrows + 1)) return -1;
+  if (grow(&M->colind, &colind_cap, nnz)) return -1;
+  if (grow(&M->val, &M->nnz_cap, nnz)) return -1;
+  return 0;
+}
+
+void spgemm_free(struct spgemm_csr *M) {
+  hugepage_free(M->val);
+  hugepage_free(M->colind);
+  hugepage_free(M->off);
+  memset(M, 0, sizeof(*M));
+}
+
+int spgemm_copy(struct spgemm_csr *dst, const struct spgemm_csr *src) {
+  const uint64_t nnz = src->off[src->nrows];
+  if (spgemm_reserve(dst, src->nrows, nnz)) return -1;
+  dst->nrows = src->nrows;
+  dst->ncols = src->ncols;
+  memcpy(dst->off, src->off, (src->nrows + 1) * sizeof(*src->off));
+  memcpy(dst->colind, src->colind, nnz * sizeof(*src->colind));
+  memcpy(dst->val, src->val, nnz * sizeof(*src->val));
+  return 0;
+}
+
+static int cmp_entry(const void *pa, const void *pb) {
+  const uint64_t *a = pa, *b = pb;
+  if (a[0] != b[0]) return a[0] < b[0] ? -1 : 1;
+  return a[1] < b[1] ? -1 : a[1] > b[1];
+}
+
+int spgemm_from_tuples(struct spgemm_csr *M, uint64_t nrows, uint64_t ncols,
+                       const int64_t *I, const int64_t *J, const uint64_t *V,
+                       uint64_t n) {
+  if (spgemm_reserve(M, nrows, n)) return -1;
+  M->nrows = nrows;
+  M->ncols = ncols;
+  uint64_t *restrict off = M->off;
+  memset(off, 0, (nrows + 1) * sizeof(*off));
+  for (uint64_t k = 0; k < n; ++k) ++off[I[k] + 1];
+  for (uint64_t i = 0; i < nrows; ++i) off[i + 1] += off[i];
+
+  /* Rows as (column, value) pairs, sorted, then duplicates dropped. */
+  uint64_t *pairs = malloc((n ? n : 1) * 2 * sizeof(*pairs));
+  uint64_t *cursor = malloc((nrows ? nrows : 1) * sizeof(*cursor));
+  if (!pairs || !cursor) {
+    free(cursor);
+    free(pairs);
+    errno = ENOMEM;
+    return -1;
+  }
+  memcpy(cursor, off, nrows * sizeof(*cursor));
+  for (uint64_t k = 0; k < n; ++k) {
+    const uint64_t pos = cursor[I[k]]++;
+    pairs[2 * pos] = J[k];
+    pairs[2 * pos + 1] = V[k];
+  }
+  OMP(parallel for schedule(dynamic, 256))
+  for (int64_t i = 0; i < (int64_t)nrows; ++i) {
+    uint64_t *row = pairs + 2 * off[i];
+    const uint64_t len = off[i + 1] - off[i];
+    qsort(row, len, 2 * sizeof(*row), cmp_entry);
+    uint64_t kept = 0;
+    for (uint64_t k = 0; k < len; ++k)
+      if (!kept || row[2 * k] != row[2 * (kept - 1)]) {
+        row[2 * kept] = row[2 * k];
+        row[2 * kept + 1] = row[2 * k + 1];
+        ++kept;
+      }
+    cursor[i] = kept;
+  }
+
+  uint64_t nnz = 0;
+  for (uint64_t i = 0; i < nrows; ++i) {
+    const uint64_t *row = pairs + 2 * off[i];
+    off[i] = nnz;
+    for (uint64_t k = 0; k < cursor[i]; ++k, ++nnz) {
+      M->colind[nnz] = row[2 * k];
+      M->val[nnz] = row[2 * k + 1];
+    }
+  }
+  off[nrows] = nnz;
+  free(cursor);
+  free(pairs);
+  return 0;
+}
+
+int spgemm_transpose(struct spgemm_csr *AT, const struct spgemm_csr *A) {
+  const uint64_t nnz = A->off[A->nrows];
+  if (spgemm_reserve(AT, A->ncols, nnz)) return -1;
+  AT->nrows = A->ncols;
+  AT->ncols = A->nrows;
+
+  uint64_t *restrict off = AT->off;
+  memset(off, 0, (AT->nrows + 1) * sizeof(*off));
+  OMP(parallel for)
+  for (int64_t k = 0; k < (int64_t)nnz; ++k) {
+    OMP(atomic)
+    ++off[A->colind[k] + 1];
+  }
+  for (uint64_t j = 0; j < AT->nrows; ++j) off[j + 1] += off[j];
+
+  uint64_t *cursor = malloc((AT->nrows ? AT->nrows : 1) * sizeof(*cursor));
+  if (!cursor) {
+    errno = ENOMEM;
+    return -1;
+  }
+  memcpy(cursor, off, AT->nrows * sizeof(*cursor));
+  OMP(parallel for schedule(dynamic, 256))
+  for (int64_t i = 0; i < (int64_t)A->nrows; ++i)
+    for (uint64_t k = A->off[i]; k < A->off[i + 1]; ++k) {
+      uint64_t pos;
+      OMP(atomic capture)
+      pos = cursor[A->colind[k]]++;
+      AT->colind[pos] = i;
+      AT->val[pos] = A->val[k];
+    }
+  free(cursor);
+  return 0;
+}
+
+/* Per-thread accumulators.  The dense one is indexed by column; mark[j]
+   holds the stamp of the last row pass that touched j, so nothing is
+   cleared between rows.  The bitmap keeps one bit per column instead of
+   a stamp and clears the bits it set.  The hash table is sized per row
+   to at least twice the row's flop count.  The heap merges the B rows
+   selected by a row of A, one entry per row. */
+struct heap_ent {
+  uint64_t col, pos, end, a;
+};
+
+struct accum {
+  uint64_t *dval, *dmark;
+  size_t dcap;
+  uint64_t *bits, *touched;
+  size_t touched_cap;
+  uint64_t *hkey, *hval;
+  size_t hcap, hval_cap;
+  struct heap_ent *heap;
+  size_t heap_cap;
+};
+
+#define SR_MULT(sr, a, b) ((sr) == SPGEMM_MIN_FIRST ? (a) : (a) * (b))
+#define SR_ADD(sr, x, y) \
+  ((sr) == SPGEMM_MIN_FIRST ? ((y) < (x) ? (y) : (x)) : (x) + (y))
+
+#define HASH_EMPTY UINT64_MAX
+
+static int accum_dense(struct accum *w, uint64_t ncols) {
+  if (w->dmark) return 0;
+  if (grow(&w->dval, &w->dcap, ncols)) return -1;
+  w->dmark = calloc(ncols ? ncols : 1, sizeof(*w->dmark));
+  if (!w->dmark) return -1;
+  return 0;
+}
+
+static int accum_bitmap(struct accum *w, uint64_t ncols, uint64_t flops) {
+  if (!w->bits) {
+    size_t dcap = w->dcap;
+    if (grow(&w->dval, &dcap, ncols)) return -1;
+    w->dcap = dcap;
+    w->bits = calloc((ncols + 63) / 64 + 1, sizeof(*w->bits));
+    if (!w->bits) return -1;
+  }
+  return grow(&w->touched, &w->touched_cap, flops < ncols ? flops : ncols);
+}
+
+static int accum_heap(struct accum *w, uint64_t n) {
+  if (n <= w->heap_cap && w->heap) return 0;
+  free(w->heap);
+  w->heap = malloc((n ? n : 1) * sizeof(*w->heap));
+  w->heap_cap = w->heap ? n : 0;
+  return w->heap ? 0 : -1;
+}
+
+static int accum_hash(struct accum *w, uint64_t flops, int *lg) {
+  size_t sz = 8;
+  *lg = 3;
+  while (sz < 2 * flops) {
+    sz <<= 1;
+    ++*lg;
+  }
+  size_t hval_cap = w->hval_cap;
+  if (grow(&w->hkey, &w->hcap, sz)) return -1;
+  if (grow(&w->hval, &hval_cap, sz)) return -1;
+  w->hval_cap = hval_cap;
+  for (size_t k = 0; k < sz; ++k) w->hkey[k] = HASH_EMPTY;
+  return 0;
+}
+
+static void accum_release(struct accum *w) {
+  hugepage_free(w->dval);
+  free(w->dmark);
+  free(w->bits);
+  hugepage_free(w->touched);
+  free(w->heap);
+  hugepage_free(w->hkey);
+  hugepage_free(w->hval);
+}
+
+static inline uint64_t hash_slot(uint64_t j, int lg) {
+  return (j * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - lg);
+}
+
+static uint64_t row_flops(const struct spgemm_csr *A, const struct spgemm_csr *B,
+                          uint64_t i) {
+  uint64_t f = 0;
+  for (uint64_t ka = A->off[i]; ka < A->off[i + 1]; ++ka) {
+    const uint64_t k = A->colind[ka];
+    f += B->off[k + 1] - B->off[k];
+  }
+  return f;
+}
+
+static int use_hash(enum spgemm_accum acc, uint64_t flops, uint64_t ncols) {
+  if (acc == SPGEMM_ACCUM_DENSE) return 0;
+  if (acc == SPGEMM_ACCUM_HASH) return 1;
+  /* Sparse rows of a wide result would touch scattered cache lines of
+     the dense arrays for little work. */
+  return flops * 8 < ncols;
+}
+
+static void heap_sift_down(struct heap_ent *h, uint64_t n, uint64_t k) {
+  const struct heap_ent e = h[k];
+  for (;;) {
+    uint64_t c = 2 * k + 1;
+    if (c >= n) break;
+    if (c + 1 < n && h[c + 1].col < h[c].col) ++c;
+    if (h[c].col >= e.col) break;
+    h[k] = h[c];
+    k = c;
+  }
+  h[k] = e;
+}
+
+/* Multi-way merge of the B rows selected by row i of A.  Needs B's rows
+   sorted and emits sorted rows.  With ci NULL, only counts. */
+static inline int64_t heap_row(struct accum *w, const struct spgemm_csr *A,
+                               const struct spgemm_csr *B, uint64_t i,
+                               uint64_t *restrict ci, uint64_t *restrict cv,
+                               const enum spgemm_semiring sr) {
+  if (accum_heap(w, A->off[i + 1] - A->off[i])) return -1;
+  struct heap_ent *h = w->heap;
+  uint64_t nh = 0;
+  for (uint64_t ka = A->off[i]; ka < A->off[i + 1]; ++ka) {
+    const uint64_t k = A->colind[ka];
+    if (B->off[k] < B->off[k + 1])
+      h[nh++] = (struct heap_ent){B->colind[B->off[k]], B->off[k],
+                                  B->off[k + 1], A->val[ka]};
+  }
+  for (uint64_t k = nh / 2; k-- > 0;) heap_sift_down(h, nh, k);
+
+  int64_t n = 0;
+  uint64_t last = UINT64_MAX;
+  while (nh) {
+    const uint64_t j = h[0].col;
+    if (j != last) {
+      last = j;
+      if (ci) {
+        ci[n] = j;
+        cv[n] = SR_MULT(sr, h[0].a, B->val[h[0].pos]);
+      }
+      ++n;
+    } else if (ci)
+      cv[n - 1] = SR_ADD(sr, cv[n - 1], SR_MULT(sr, h[0].a, B->val[h[0].pos]));
+    if (++h[0].pos < h[0].end)
+      h[0].col = B->colind[h[0].pos];
+    else
+      h[0] = h[--nh];
+    heap_sift_down(h, nh, 0);
+  }
+  return n;
+}
+
+static inline int64_t bitmap_row(struct accum *w, const struct spgemm_csr *A,
+                                 const struct spgemm_csr *B, uint64_t i,
+                                 uint64_t flops, uint64_t *restrict ci,
+                                 uint64_t *restrict cv,
+                                 const enum spgemm_semiring sr) {
+  if (accum_bitmap(w, B->ncols, flops)) return -1;
+  uint64_t *restrict bits = w->bits;
+  uint64_t *restrict list = ci ? ci : w->touched;
+  int64_t n = 0;
+  for (uint64_t ka = A->off[i]; ka < A->off[i + 1]; ++ka) {
+    const uint64_t k = A->colind[ka], a = A->val[ka];
+    for (uint64_t kb = B->off[k]; kb < B->off[k + 1]; ++kb) {
+      const uint64_t j = B->colind[kb], bit = (uint64_t)1 << (j % 64);
+      if (!(bits[j / 64] & bit)) {
+        bits[j / 64] |= bit;
+        list[n++] = j;
+        if (ci) w->dval[j] = SR_MULT(sr, a, B->val[kb]);
+      } else if (ci)
+        w->dval[j] = SR_ADD(sr, w->dval[j], SR_MULT(sr, a, B->val[kb]));
+    }
+  }
+  for (int64_t t = 0; t < n; ++t) {
+    const uint64_t j = list[t];
+    bits[j / 64] = 0;
+    if (ci) cv[t] = w->dval[j];
+  }
+  return n;
+}
+
+/* Number of distinct columns in row i of A*B, or -1 on allocation
+   failure. */
+static int64_t symbolic_row(struct accum *w, const struct spgemm_csr *A,
+                            const struct spgemm_csr *B, uint64_t i,
+                            enum spgemm_accum acc) {
+  const uint64_t flops = row_flops(A, B, i);
+  int64_t n = 0;
+  if (!flops) return 0;
+  if (acc == SPGEMM_ACCUM_HEAP)
+    return heap_row(w, A, B, i, NULL, NULL, SPGEMM_MIN_FIRST);
+  if (acc == SPGEMM_ACCUM_BITMAP)
+    return bitmap_row(w, A, B, i, flops, NULL, NULL, SPGEMM_MIN_FIRST);
+  if (use_hash(acc, flops, B->ncols)) {
+    int lg;
+    if (accum_hash(w, flops, &lg)) return -1;
+    const uint64_t mask = ((uint64_t)1 << lg) - 1;
+    for (uint64_t ka = A->off[i]; ka < A->off[i + 1]; ++ka) {
+      const uint64_t k = A->colind[ka];
+      for (uint64_t kb = B->off[k]; kb < B->off[k + 1]; ++kb) {
+        const uint64_t j = B->colind[kb];
+        uint64_t h = hash_slot(j, lg);
+        while (w->hkey[h] != HASH_EMPTY && w->hkey[h] != j) h = (h + 1) & mask;
+        if (w->hkey[h] == HASH_EMPTY) {
+          w->hkey[h] = j;
+          ++n;
+        }
+      }
+    }
+  } else {
+    if (accum_dense(w, B->ncols)) return -1;
+    const uint64_t stamp = 2 * i + 1;
+    for (uint64_t ka = A->off[i]; ka < A->off[i + 1]; ++ka) {
+      const uint64_t k = A->colind[ka];
+      for (uint64_t kb = B->off[k]; kb < B->off[k + 1]; ++kb) {
+        const uint64_t j = B->colind[kb];
+        if (w->dmark[j] != stamp) {
+          w->dmark[j] = stamp;
+          ++n;
+        }
+      }
+    }
+  }
+  return n;
+}
+
+/* Fill row i of C.  Called with a literal semiring so each use is
+   specialized. */
+static inline int numeric_row(struct accum *w, struct spgemm_csr *C,
+                              const struct spgemm_csr *A,
+                              const struct spgemm_csr *B, uint64_t i,
+                              enum spgemm_accum acc,
+                              const enum spgemm_semiring sr) {
+#define MULT(a, b) SR_MULT(sr, a, b)
+#define ADD(x, y) SR_ADD(sr, x, y)
+  uint64_t *restrict ci = C->colind + C->off[i];
+  uint64_t *restrict cv = C->val + C->off[i];
+  const uint64_t flops = row_flops(A, B, i);
+  uint64_t n = 0;
+  if (!flops) return 0;
+  if (acc == SPGEMM_ACCUM_HEAP)
+    return heap_row(w, A, B, i, ci, cv, sr) < 0 ? -1 : 0;
+  if (acc == SPGEMM_ACCUM_BITMAP)
+    return bitmap_row(w, A, B, i, flops, ci, cv, sr) < 0 ? -1 : 0;
+  if (use_hash(acc, flops, B->ncols)) {
+    int lg;
+    if (accum_hash(w, flops, &lg)) return -1;
+    const uint64_t mask = ((uint64_t)1 << lg) - 1;
+    for (uint64_t ka = A->off[i]; ka < A->off[i + 1]; ++ka) {
+      const uint64_t k = A->colind[ka], a = A->val[ka];
+      for (uint64_t kb = B->off[k]; kb < B->off[k + 1]; ++kb) {
+        const uint64_t j = B->colind[kb], x = MULT(a, B->val[kb]);
+        uint64_t h = hash_slot(j, lg);
+        while (w->hkey[h] != HASH_EMPTY && w->hkey[h] != j) h = (h + 1) & mask;
+        if (w->hkey[h] == HASH_EMPTY) {
+          w->hkey[h] = j;
+          w->hval[h] = x;
+        } else
+          w->hval[h] = ADD(w->hval[h], x);
+      }
+    }
+    for (uint64_t h = 0; h <= mask; ++h)
+      if (w->hkey[h] != HASH_EMPTY) {
+        ci[n] = w->hkey[h];
+        cv[n++] = w->hval[h];
+      }
+  } else {
+    if (accum_dense(w, B->ncols)) return -1;
+    const uint64_t stamp = 2 * i + 2;
+    for (uint64_t ka = A->off[i]; ka < A->off[i + 1]; ++ka) {
+      const uint64_t k = A->colind[ka], a = A->val[ka];
+      for (uint64_t kb = B->off[k]; kb < B->off[k + 1]; ++kb) {
+        const uint64_t j = B->colind[kb], x = MULT(a, B->val[kb]);
+        if (w->dmark[j] != stamp) {
+          w->dmark[j] = stamp;
+          w->dval[j] = x;
+          ci[n++] = j;
+        } else
+          w->dval[j] = ADD(w->dval[j], x);
+      }
+    }
+    for (uint64_t t = 0; t < n; ++t) cv[t] = w->dval[ci[t]];
+  }
+  return 0;
+#undef ADD
+#undef MULT
+}
+
+int spgemm_mxm(struct spgemm_csr *C, const struct spgemm_csr *A,
+               const struct spgemm_csr *B, enum spgemm_semiring sr,
+               enum spgemm_accum acc) {
+  if (A->ncols != B->nrows || C == A || C == B) {
+    errno = EINVAL;
+    return -1;
+  }
+  const int64_t nrows = A->nrows;
+  if (spgemm_reserve(C, nrows, 0)) return -1;
+  C->nrows = nrows;
+  C->ncols = B->ncols;
+  C->off[0] = 0;
+
+  int err = 0;
+  OMP(parallel) {
+    struct accum w;
+    memset(&w, 0, sizeof(w));
+
+    OMP(for schedule(dynamic, 256))
+    for (int64_t i = 0; i < nrows; ++i) {
+      int failed;
+      OMP(atomic read)
+      failed = err;
+      const int64_t n = failed ? 0 : symbolic_row(&w, A, B, i, acc);
+      if (n < 0) {
+        OMP(atomic write)
+        err = 1;
+      }
+      C->off[i + 1] = n < 0 ? 0 : n;
+    }
+
+    OMP(single) {
+      int failed;
+      OMP(atomic read)
+      failed = err;
+      for (int64_t i = 0; i < nrows; ++i) C->off[i + 1] += C->off[i];
+      if (!failed && spgemm_reserve(C, nrows, C->off[nrows])) {
+        OMP(atomic write)
+        err = 1;
+      }
+    }
+
+    OMP(for schedule(dynamic, 256))
+    for (int64_t i = 0; i < nrows; ++i) {
+      int failed;
+      OMP(atomic read)
+      failed = err;
+      if (failed) continue;
+      const int rc = sr == SPGEMM_MIN_FIRST
+                         ? numeric_row(&w, C, A, B, i, acc, SPGEMM_MIN_FIRST)
+                         : numeric_row(&w, C, A, B, i, acc, SPGEMM_PLUS_TIMES);
+      if (rc) {
+        OMP(atomic write)
+        err = 1;
+      }
+    }
+    accum_release(&w);
+  }
+  if (err) {
+    errno = ENOMEM;
+    return -1;
+  }
+  return 0;
+}
+
+uint64_t spgemm_flops(const struct spgemm_csr *A, const struct spgemm_csr *B) {
+  uint64_t f = 0;
+  OMP(parallel for reduction(+ : f) schedule(dynamic, 256))
+  for (int64_t i = 0; i < (int64_t)A->nrows; ++i) f += row_flops(A, B, i);
+  return f;
+}
+
+int spgemm_dense_from_csr(struct spgemm_dense *D, const struct spgemm_csr *B) {
+  const uint64_t nc = B->ncols;
+  if (grow(&D->val, &D->cap, B->nrows * nc)) return -1;
+  D->nrows = B->nrows;
+  D->ncols = nc;
+  OMP(parallel for)
+  for (int64_t i = 0; i < (int64_t)B->nrows; ++i) {
+    uint64_t *restrict d = D->val + i * nc;
+    for (uint64_t j = 0; j < nc; ++j) d[j] = SPGEMM_ABSENT;
+    for (uint64_t k = B->off[i]; k < B->off[i + 1]; ++k)
+      d[B->colind[k]] = B->val[k];
+  }
+  return 0;
+}
+
+/* c = c (+) a (x) b over a dense row.  The loop has no dependences, so
+   with a literal ncols (16, the timer's default width) it unrolls into
+   full vector operations. */
+static inline void spmm_axpy(uint64_t *restrict c, const uint64_t *restrict b,
+                             const uint64_t a, const uint64_t ncols,
+                             const enum spgemm_semiring sr) {
+  if (sr == SPGEMM_MIN_FIRST) {
+    /* SPGEMM_ABSENT is min's identity. */
+    OMP(simd)
+    for (uint64_t j = 0; j < ncols; ++j) {
+      const uint64_t x = b[j] != SPGEMM_ABSENT ? a : SPGEMM_ABSENT;
+      c[j] = x < c[j] ? x : c[j];
+    }
+  } else {
+    OMP(simd)
+    for (uint64_t j = 0; j < ncols; ++j) {
+      const uint64_t x = a * b[j];
+      c[j] = b[j] == SPGEMM_ABSENT ? c[j] : c[j] == SPGEMM_ABSENT ? x : c[j] + x;
+    }
+  }
+}
+
+/* One row of C = A * B with B dense. */
+static inline void spmm_row(uint64_t *restrict c, const struct spgemm_csr *A,
+                            const uint64_t *restrict B, uint64_t i,
+                            const uint64_t ncols,
+                            const enum spgemm_semiring sr) {
+  for (uint64_t j = 0; j < ncols; ++j) c[j] = SPGEMM_ABSENT;
+  for (uint64_t ka = A->off[i]; ka < A->off[i + 1]; ++ka)
+    spmm_axpy(c, B + A->colind[ka] * ncols, A->val[ka], ncols, sr);
+}
+
+int spgemm_spmm(struct spgemm_dense *C, const struct spgemm_csr *A,
+                const struct spgemm_dense *B, enum spgemm_semiring sr) {
+  if (A->ncols != B->nrows || C == B) {
+    errno = EINVAL;
+    return -1;
+  }
+  const uint64_t nc = B->ncols;
+  if (grow(&C->val, &C->cap, A->nrows * nc)) return -1;
+  C->nrows = A->nrows;
+  C->ncols = nc;
+  OMP(parallel for schedule(dynamic, 256))
+  for (int64_t i = 0; i < (int64_t)A->nrows; ++i) {
+    uint64_t *c = C->val + i * nc;
+    if (nc == 16) {
+      if (sr == SPGEMM_MIN_FIRST)
+        spmm_row(c, A, B->val, i, 16, SPGEMM_MIN_FIRST);
+      else
+        spmm_row(c, A, B->val, i, 16, SPGEMM_PLUS_TIMES);
+    } else if (sr == SPGEMM_MIN_FIRST)
+      spmm_row(c, A, B->val, i, nc, SPGEMM_MIN_FIRST);
+    else
+      spmm_row(c, A, B->val, i, nc, SPGEMM_PLUS_TIMES);
+  }
+  return 0;
+}
+
+uint64_t spgemm_dense_nvals(const struct spgemm_dense *D) {
+  uint64_t n = 0;
+  const int64_t len = D->nrows * D->ncols;
+  OMP(parallel for reduction(+ : n))
+  for (int64_t k = 0; k < len; ++k) n += D->val[k] != SPGEMM_ABSENT;
+  return n;
+}
+
+void spgemm_dense_free(struct spgemm_dense *D) {
+  hugepage_free(D->val);
+  memset(D, 0, sizeof(*D));
+}
+
+uint64_t spgemm_l2_bytes(void) {
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+  const long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  if (l2 > 0) return l2;
+#endif
+  return 1 << 20;
+}
+
+void spgemm_tile_auto(uint64_t b_ncols, uint64_t *row_block,
+                      uint64_t *col_block) {
+  /* Half of L2 for a column block's rows of B, half for a row block's
+     rows of C, both counted as dense rows. */
+  uint64_t n = spgemm_l2_bytes() / 2 / ((b_ncols ? b_ncols : 1) * sizeof(uint64_t));
+  if (n < 64) n = 64;
+  *row_block = *col_block = n;
+}
+
+int spgemm_tile(struct spgemm_tiled *T, const struct spgemm_csr *A,
+                uint64_t row_block, uint64_t col_block) {
+  if (!row_block || !col_block || row_block > UINT32_MAX) {
+    errno = EINVAL;
+    return -1;
+  }
+  const uint64_t nrb = (A->nrows + row_block - 1) / row_block;
+  const uint64_t ncb = (A->ncols + col_block - 1) / col_block;
+  const uint64_t nnz = A->off[A->nrows];
+  size_t colind_cap = T->nnz_cap;
+  if (grow(&T->blk_off, &T->blk_cap, nrb + 1)) return -1;
+  if (grow32(&T->row, &T->row_cap, nnz)) return -1;
+  if (grow(&T->colind, &colind_cap, nnz)) return -1;
+  if (grow(&T->val, &T->nnz_cap, nnz)) return -1;
+  T->nrows = A->nrows;
+  T->ncols = A->ncols;
+  T->row_block = row_block;
+  T->col_block = col_block;
+  T->nrb = nrb;
+
+  /* A row block's entries keep their positions in A as a whole and are
+     counting-sorted by column block, which leaves each tile in row
+     order. */
+  uint64_t ntiles = 0;
+  int err = 0;
+  OMP(parallel) {
+    uint64_t *cursor = malloc((ncb + 1) * sizeof(*cursor));
+    if (!cursor) {
+      OMP(atomic write)
+      err = 1;
+    }
+    OMP(for schedule(dynamic, 1) reduction(+ : ntiles))
+    for (int64_t rb = 0; rb < (int64_t)nrb; ++rb) {
+      if (!cursor) continue;
+      const uint64_t r0 = rb * row_block;
+      const uint64_t r1 = A->nrows - r0 < row_block ? A->nrows : r0 + row_block;
+      T->blk_off[rb] = A->off[r0];
+      memset(cursor, 0, (ncb + 1) * sizeof(*cursor));
+      for (uint64_t k = A->off[r0]; k < A->off[r1]; ++k)
+        ++cursor[A->colind[k] / col_block + 1];
+      uint64_t pos = A->off[r0];
+      for (uint64_t cb = 0; cb < ncb; ++cb) {
+        const uint64_t len = cursor[cb + 1];
+        ntiles += len != 0;
+        cursor[cb] = pos;
+        pos += len;
+      }
+      for (uint64_t i = r0; i < r1; ++i)
+        for (uint64_t k = A->off[i]; k < A->off[i + 1]; ++k) {
+          const uint64_t p = cursor[A->colind[k] / col_block]++;
+          T->row[p] = i - r0;
+          T->colind[p] = A->colind[k];
+          T->val[p] = A->val[k];
+        }
+    }
+    free(cursor);
+  }
+  T->blk_off[nrb] = nnz;
+  T->ntiles = ntiles;
+  if (err) {
+    errno = ENOMEM;
+    return -1;
+  }
+  return 0;
+}
+
+static uint64_t block_rows(const struct spgemm_tiled *A, uint64_t rb) {
+  const uint64_t r0 = rb * A->row_block;
+  return A->nrows - r0 < A->row_block ? A->nrows - r0 : A->row_block;
+}
+
+/* Row block rb of A * B into acc, block_rows by B->ncols, which starts
+   out all SPGEMM_ABSENT. */
+static inline void tiled_block(uint64_t *restrict acc,
+                               const struct spgemm_tiled *A,
+                               const struct spgemm_csr *B, uint64_t rb,
+                               const enum spgemm_semiring sr) {
+  const uint64_t nc = B->ncols;
+  for (uint64_t e = A->blk_off[rb]; e < A->blk_off[rb + 1]; ++e) {
+    uint64_t *restrict c = acc + (uint64_t)A->row[e] * nc;
+    const uint64_t k = A->colind[e], a = A->val[e];
+    for (uint64_t kb = B->off[k]; kb < B->off[k + 1]; ++kb) {
+      const uint64_t j = B->colind[kb], x = SR_MULT(sr, a, B->val[kb]);
+      c[j] = c[j] == SPGEMM_ABSENT ? x : SR_ADD(sr, c[j], x);
+    }
+  }
+}
+
+int spgemm_mxm_tiled(struct spgemm_csr *C, const struct spgemm_tiled *A,
+                     const struct spgemm_csr *B, enum spgemm_semiring sr) {
+  if (A->ncols != B->nrows || C == B) {
+    errno = EINVAL;
+    return -1;
+  }
+  const uint64_t nc = B->ncols, nrb = A->nrb;
+  const uint64_t acc_len =
+      (A->nrows < A->row_block ? A->nrows : A->row_block) * nc;
+  if (spgemm_reserve(C, A->nrows, 0)) return -1;
+  C->nrows = A->nrows;
+  C->ncols = nc;
+  C->off[0] = 0;
+
+  /* Each row block is packed into its own buffer while its accumulator
+     is hot, then copied into place once C's offsets are known. */
+  uint64_t **packed = calloc(nrb ? nrb : 1, sizeof(*packed));
+  if (!packed) return -1;
+  int err = 0;
+  OMP(parallel) {
+    uint64_t *acc = malloc((acc_len ? acc_len : 1) * sizeof(*acc));
+    if (!acc) {
+      OMP(atomic write)
+      err = 1;
+    }
+
+    OMP(for schedule(dynamic, 1))
+    for (int64_t rb = 0; rb < (int64_t)nrb; ++rb) {
+      int failed;
+      OMP(atomic read)
+      failed = err;
+      if (failed) continue;
+      const uint64_t r0 = rb * A->row_block, nr = block_rows(A, rb);
+      for (uint64_t t = 0; t < nr * nc; ++t) acc[t] = SPGEMM_ABSENT;
+      if (sr == SPGEMM_MIN_FIRST)
+        tiled_block(acc, A, B, rb, SPGEMM_MIN_FIRST);
+      else
+        tiled_block(acc, A, B, rb, SPGEMM_PLUS_TIMES);
+      uint64_t n = 0;
+      for (uint64_t t = 0; t < nr * nc; ++t) n += acc[t] != SPGEMM_ABSENT;
+      uint64_t *out = packed[rb] = malloc((n ? 2 * n : 1) * sizeof(*out));
+      if (!out) {
+        OMP(atomic write)
+        err = 1;
+        continue;
+      }
+      n = 0;
+      for (uint64_t r = 0; r < nr; ++r) {
+        const uint64_t *restrict c = acc + r * nc;
+        const uint64_t row_begin = n;
+        for (uint64_t j = 0; j < nc; ++j)
+          if (c[j] != SPGEMM_ABSENT) {
+            out[2 * n] = j;
+            out[2 * n + 1] = c[j];
+            ++n;
+          }
+        C->off[r0 + r + 1] = n - row_begin;
+      }
+    }
+
+    OMP(single) {
+      if (!err) {
+        for (uint64_t i = 0; i < A->nrows; ++i) C->off[i + 1] += C->off[i];
+        if (spgemm_reserve(C, A->nrows, C->off[A->nrows])) err = 1;
+      }
+    }
+
+    OMP(for schedule(dynamic, 1))
+    for (int64_t rb = 0; rb < (int64_t)nrb; ++rb) {
+      const uint64_t *restrict out = packed[rb];
+      if (!err && out) {
+        const uint64_t r0 = rb * A->row_block, nr = block_rows(A, rb);
+        const uint64_t base = C->off[r0], n = C->off[r0 + nr] - base;
+        for (uint64_t t = 0; t < n; ++t) {
+          C->colind[base + t] = out[2 * t];
+          C->val[base + t] = out[2 * t + 1];
+        }
+      }
+      free(packed[rb]);
+    }
+    free(acc);
+  }
+  free(packed);
+  if (err) {
+    errno = ENOMEM;
+    return -1;
+  }
+  return 0;
+}
+
+static inline void spmm_block(uint64_t *restrict c, const struct spgemm_tiled *A,
+                              const uint64_t *restrict B, uint64_t rb,
+                              const uint64_t ncols,
+                              const enum spgemm_semiring sr) {
+  for (uint64_t e = A->blk_off[rb]; e < A->blk_off[rb + 1]; ++e)
+    spmm_axpy(c + (uint64_t)A->row[e] * ncols, B + A->colind[e] * ncols,
+              A->val[e], ncols, sr);
+}
+
+int spgemm_spmm_tiled(struct spgemm_dense *C, const struct spgemm_tiled *A,
+                      const struct spgemm_dense *B, enum spgemm_semiring sr) {
+  if (A->ncols != B->nrows || C == B) {
+    errno = EINVAL;
+    return -1;
+  }
+  const uint64_t nc = B->ncols;
+  if (grow(&C->val, &C->cap, A->nrows * nc)) return -1;
+  C->nrows = A->nrows;
+  C->ncols = nc;
+  OMP(parallel for schedule(dynamic, 1))
+  for (int64_t rb = 0; rb < (int64_t)A->nrb; ++rb) {
+    uint64_t *c = C->val + rb * A->row_block * nc;
+    const uint64_t len = block_rows(A, rb) * nc;
+    for (uint64_t t = 0; t < len; ++t) c[t] = SPGEMM_ABSENT;
+    if (nc == 16) {
+      if (sr == SPGEMM_MIN_FIRST)
+        spmm_block(c, A, B->val, rb, 16, SPGEMM_MIN_FIRST);
+      else
+        spmm_block(c, A, B->val, rb, 16, SPGEMM_PLUS_TIMES);
+    } else if (sr == SPGEMM_MIN_FIRST)
+      spmm_block(c, A, B->val, rb, nc, SPGEMM_MIN_FIRST);
+    else
+      spmm_block(c, A, B->val, rb, nc, SPGEMM_PLUS_TIMES);
+  }
+  return 0;
+}
+
+void spgemm_tiled_free(struct spgemm_tiled *T) {
+  hugepage_free(T->val);
+  hugepage_free(T->colind);
+  hugepage_free(T->row);
+  hugepage_free(T->blk_off);
+  memset(T, 0, sizeof(*T));
+}
@@ -0,0 +1,100 @@
+#if !defined(SPGEMM_HEADER_)
+#define SPGEMM_HEADER_
+#include <stddef.h>
+#include <stdint.h>
+
+/* In-tree sparse matrix multiply on plain CSR arrays, as a reference
+   and fallback for the GraphBLAS backends.  Row-wise Gustavson with a
+   symbolic pass to size each output row and a numeric pass that writes
+   it in place.  Each thread keeps a dense accumulator (values indexed
+   by column plus a row stamp) and/or an open-addressing hash table;
+   SPGEMM_ACCUM_AUTO picks per row from the row's flop count.  The
+   bitmap accumulator trades the stamp array for one bit per column.
+   Column indices within an output row come out in accumulator order,
+   not sorted, except with SPGEMM_ACCUM_HEAP: a multi-way merge that
+   requires B's rows sorted and keeps C's rows sorted.
+
+   Arrays come from hugepage_malloc and grow only, so a struct reused
+   across calls stops allocating once it has seen its largest result.
+   Functions return 0 on success and -1 with errno set otherwise. */
+
+struct spgemm_csr {
+  uint64_t nrows, ncols;
+  uint64_t *off;    /* nrows + 1 */
+  uint64_t *colind; /* off[nrows] */
+  uint64_t *val;    /* off[nrows] */
+  size_t off_cap, nnz_cap;
+};
+
+enum spgemm_semiring { SPGEMM_MIN_FIRST = 0, SPGEMM_PLUS_TIMES };
+
+enum spgemm_accum {
+  SPGEMM_ACCUM_AUTO = 0,
+  SPGEMM_ACCUM_DENSE,
+  SPGEMM_ACCUM_HASH,
+  SPGEMM_ACCUM_HEAP,
+  SPGEMM_ACCUM_BITMAP
+};
+
+/* Row-major dense block for the sparse-times-dense (SpMM) path, once B
+   has filled in.  Absent entries hold SPGEMM_ABSENT. */
+#define SPGEMM_ABSENT UINT64_MAX
+
+struct spgemm_dense {
+  uint64_t nrows, ncols;
+  uint64_t *val; /* nrows * ncols */
+  size_t cap;
+};
+
+enum spgemm_accum spgemm_accum_parse (const char *);
+const char *spgemm_accum_name (enum spgemm_accum);
+
+int spgemm_reserve (struct spgemm_csr *, uint64_t nrows, uint64_t nnz);
+int spgemm_copy (struct spgemm_csr *dst, const struct spgemm_csr *src);
+/* Sorted rows; of duplicate (I, J) tuples the smallest value is kept. */
+int spgemm_from_tuples (struct spgemm_csr *, uint64_t nrows, uint64_t ncols,
+                        const int64_t *I, const int64_t *J, const uint64_t *V,
+                        uint64_t n);
+/* Multiply-adds in A*B. */
+uint64_t spgemm_flops (const struct spgemm_csr *A, const struct spgemm_csr *B);
+int spgemm_transpose (struct spgemm_csr *AT, const struct spgemm_csr *A);
+int spgemm_mxm (struct spgemm_csr *C, const struct spgemm_csr *A,
+                const struct spgemm_csr *B, enum spgemm_semiring,
+                enum spgemm_accum);
+void spgemm_free (struct spgemm_csr *);
+
+int spgemm_dense_from_csr (struct spgemm_dense *, const struct spgemm_csr *);
+int spgemm_spmm (struct spgemm_dense *C, const struct spgemm_csr *A,
+                 const struct spgemm_dense *B, enum spgemm_semiring);
+uint64_t spgemm_dense_nvals (const struct spgemm_dense *);
+void spgemm_dense_free (struct spgemm_dense *);
+
+/* A cut into 2D tiles for the hop loop's narrow B: row blocks of
+   row_block rows, and within each row block the entries ordered by
+   column block of col_block columns, then by row.  A row block's pass
+   then reads one column block's rows of B at a time while its rows of
+   C stay in a dense row_block by B->ncols accumulator.  With
+   spgemm_tile_auto's sizes both halves fit in L2.  Result rows come
+   out sorted. */
+struct spgemm_tiled {
+  uint64_t nrows, ncols, row_block, col_block, nrb;
+  uint64_t ntiles;    /* nonempty tiles */
+  uint64_t *blk_off;  /* nrb + 1 */
+  uint32_t *row;      /* within the row block */
+  uint64_t *colind, *val;
+  size_t blk_cap, row_cap, nnz_cap;
+};
+
+/* L2 size in bytes, or 1 MiB if the system does not say. */
+uint64_t spgemm_l2_bytes (void);
+void spgemm_tile_auto (uint64_t b_ncols, uint64_t *row_block,
+                       uint64_t *col_block);
+int spgemm_tile (struct spgemm_tiled *, const struct spgemm_csr *A,
+                 uint64_t row_block, uint64_t col_block);
+int spgemm_mxm_tiled (struct spgemm_csr *C, const struct spgemm_tiled *A,
+                      const struct spgemm_csr *B, enum spgemm_semiring);
+int spgemm_spmm_tiled (struct spgemm_dense *C, const struct spgemm_tiled *A,
+                       const struct spgemm_dense *B, enum spgemm_semiring);
+void spgemm_tiled_free (struct spgemm_tiled *);
+
+#endif /* SPGEMM_HEADER_ */